@@ -6,6 +6,7 @@ struct VertexInput
     float3 position [[attribute(0)]];
     float3 color [[attribute(1)]];
     float2 uv [[attribute(2)]];
+    float page [[attribute(3)]];
 };
 
 struct VertexOutput
@@ -13,6 +14,7 @@ struct VertexOutput
     float4 position [[position]];
     half3 color;
     float2 uv;
+    uint page [[flat]];
 };
 
 VertexOutput vertex vertexText(
@@ -27,6 +29,7 @@ VertexOutput vertex vertexText(
     payload.position = float4(half4x4(projection) * half4x4(view) * half4x4(transform) * half4(pos, 1.0));
     payload.color = half3(input.color);
     payload.uv = input.uv;
+    payload.page = uint(input.page);
     
     return payload;
 }
@@ -36,11 +39,11 @@ VertexOutput vertex vertexText(
 half4 fragment fragmentText(
     VertexOutput frag [[stage_in]], 
     constant float4 &materialColor [[buffer(0)]],
-    texture2d<float> fontAtlas [[texture(0)]],
+    texture2d_array<float> fontAtlas [[texture(0)]],
     sampler samp [[sampler(0)]])
 {
     
-    float alpha = fontAtlas.sample(samp, frag.uv).r;
+    float alpha = fontAtlas.sample(samp, frag.uv, frag.page).r;
     
     
     if (alpha < 0.01) {
@@ -0,0 +1,39 @@
+#include <metal_stdlib>
+using namespace metal;
+
+struct UpscaleParams
+{
+    float2 uvScale;
+    float2 uvMax;
+};
+
+struct UpscaleOutput
+{
+    float4 position [[position]];
+    float2 uv;
+};
+
+// One triangle covering the target; uv spans the rendered corner of the
+// source texture.
+UpscaleOutput vertex vertexUpscale(
+    uint vertexId [[vertex_id]],
+    constant UpscaleParams &params [[buffer(0)]])
+{
+    float2 corner = float2((vertexId << 1) & 2, vertexId & 2);
+
+    UpscaleOutput payload;
+    payload.position = float4(corner * 2.0 - 1.0, 0.0, 1.0);
+    payload.uv = float2(corner.x, 1.0 - corner.y) * params.uvScale;
+    return payload;
+}
+
+half4 fragment fragmentUpscale(
+    UpscaleOutput frag [[stage_in]],
+    constant UpscaleParams &params [[buffer(0)]],
+    texture2d<float> source [[texture(0)]],
+    sampler samp [[sampler(0)]])
+{
+    // Keep bilinear taps off the texels outside the rendered region.
+    float2 uv = min(frag.uv, params.uvMax);
+    return half4(source.sample(samp, uv));
+}
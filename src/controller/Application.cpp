@@ -1,4 +1,5 @@
 #include "controller/Application.h"
+#include "engine/core/FontManager.h"
 #include "engine/core/LogManager.h"
 #include "engine/systems/MeshRenderer.h"
 #include "engine/systems/input/InputState.h"
@@ -29,16 +30,20 @@ Application::Application()
 
     MTL::Device *device = engine->device();
 
+    // The bundled UI face only ever draws its baked glyphs, so it doesn't
+    // need to keep the face data around.
+    std::string fontPath = Path::dataPath("fonts/Roboto/Roboto-Light.ttf");
+    FontManager::getInstance().setLoadMode(fontPath, FontLoadMode::Static);
+
     cubePrimitive = std::make_shared<WorldCubePrimitive>(device, 1.0f, simd::float4{0.6f, 0.8f, 1.0f, 1.0f});
     engine->addRenderable(cubePrimitive->currentRenderable());
 
     debugMonitor = std::make_shared<DebugMonitor>(device);
+    debugMonitor->bindIO(engine->io());
     engine->registerUIElement(debugMonitor);
 
     worldDebugMonitor = std::make_shared<WorldDebugMonitor>(device, 0.5f, 1.0f, 0.0f, 45.0f);
     engine->registerWorldElement(worldDebugMonitor);
-
-    std::string fontPath = Path::dataPath("fonts/Roboto/Roboto-Light.ttf");
     
     TextBoxConfig uiButtonConfig;
     uiButtonConfig.paddingLeft = 20.0f;
@@ -109,7 +114,8 @@ void Application::run()
         const float dt = static_cast<float>(ctx.deltaTime);
         cubeRotationDegrees += dt * 25.0f;
         cubePrimitive->setTransform(MetalMath::rotateZ(cubeRotationDegrees));
-        ctx.io.set("renderables.cube.rotation.deg", cubeRotationDegrees);
+        static constexpr IOKey<float> cubeRotationKey{"renderables.cube.rotation.deg"};
+        ctx.io.set(cubeRotationKey, cubeRotationDegrees);
     });
 
     LOG_FINISH("Application: run finished");
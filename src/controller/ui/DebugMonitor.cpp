@@ -3,6 +3,7 @@
 #include "engine/factories/MeshFactory.h"
 #include "engine/components/engine/Shader.h"
 #include "engine/core/LogManager.h"
+#include "engine/core/Metrics.h"
 #include "engine/systems/input/InputState.h"
 #include "engine/utils/Path.h"
 #include <iostream>
@@ -33,11 +34,11 @@ DebugMonitor::DebugMonitor(MTL::Device *device)
     config.autoSizeToContent = true;
     config.maxWidth = 400.0f;
     
-    std::string initialText = formatDebugText(createSizingDefaults());
+    currentText = formatDebugText(createSizingDefaults());
     
     textBox = std::make_shared<UITextBoxPrimitive>(
         device,
-        initialText,
+        currentText,
         fontPath,
         fontSize,
         config
@@ -55,35 +56,88 @@ DebugMonitor::DebugMonitor(MTL::Device *device)
 DebugMonitor::~DebugMonitor()
 {
     LOG_DESTROY("DebugMonitor");
+    if (io) {
+        io->unsubscribe(widthWatch);
+        io->unsubscribe(heightWatch);
+    }
 }
 
-void DebugMonitor::render(MTL::RenderCommandEncoder *encoder)
+void DebugMonitor::bindIO(EngineIO& engineIO)
 {
-    auto now = std::chrono::steady_clock::now();
-    double dt = std::chrono::duration<double>(now - lastTick).count();
-    lastTick = now;
-    accumSeconds += dt;
-    framesAccum += 1;
-    
-    if (accumSeconds >= 0.25) {
-        double instFps = framesAccum / accumSeconds;
-        smoothedFps = (smoothedFps <= 0.0) ? instFps : smoothedFps * 0.8 + instFps * 0.2;
-        
-        textBox->setText(formatDebugText(buildDebugData()));
+    io = &engineIO;
+    widthWatch = io->watch(IOKeys::WindowWidth);
+    heightWatch = io->watch(IOKeys::WindowHeight);
+}
+
+void DebugMonitor::scheduleUpdates(UpdateScheduler::Registrar registrar)
+{
+    scheduled = true;
+    registrar.addOffMain(4.0, UpdateScheduler::Priority::Low, [this](double elapsedSeconds) {
+        refreshStats(elapsedSeconds);
+    });
+}
+
+void DebugMonitor::refreshStats(double elapsedSeconds)
+{
+    if (elapsedSeconds <= 0.0 || framesAccum == 0) {
+        return;
+    }
+    double instFps = framesAccum / elapsedSeconds;
+    smoothedFps = (smoothedFps <= 0.0) ? instFps : smoothedFps * 0.8 + instFps * 0.2;
+
+    std::string text = formatDebugText(buildDebugData());
+    if (text != currentText) {
+        currentText = std::move(text);
+        textBox->setText(currentText);
         updateSizeFromPrimitives();
+        layoutDirty = true;
+    }
 
-        framesAccum = 0;
-        accumSeconds = 0.0;
+    framesAccum = 0;
+}
+
+void DebugMonitor::render(DrawList *drawList)
+{
+    framesAccum += 1;
+
+    if (!scheduled) {
+        auto now = std::chrono::steady_clock::now();
+        accumSeconds += std::chrono::duration<double>(now - lastTick).count();
+        lastTick = now;
+        if (accumSeconds >= 0.25) {
+            refreshStats(accumSeconds);
+            accumSeconds = 0.0;
+        }
     }
 
-    const float screenWidth = InputState::getWindowWidth();
-    const float screenHeight = InputState::getWindowHeight();
-    getTransform().update(screenWidth, screenHeight);
+    if (io) {
+        bool widthChanged = io->consumeChanged(widthWatch);
+        bool heightChanged = io->consumeChanged(heightWatch);
+        layoutDirty |= widthChanged || heightChanged;
+    } else {
+        layoutDirty = true;
+    }
+
+    if (layoutDirty) {
+        const float screenWidth = InputState::getWindowWidth();
+        const float screenHeight = InputState::getWindowHeight();
+        getTransform().update(screenWidth, screenHeight);
+        layoutDirty = false;
+    }
     
-    drawPrimitives(encoder);
+    drawPrimitives(drawList);
 }
 
-DebugData DebugMonitor::createSizingDefaults()
+void DebugMonitor::setWatchedMetrics(const std::vector<std::string>& names)
+{
+    watchedMetrics = names;
+    currentText = formatDebugText(createSizingDefaults());
+    textBox->setText(currentText);
+    updateSizeFromPrimitives();
+    layoutDirty = true;
+}
+
+DebugData DebugMonitor::createSizingDefaults() const
 {
     DebugData data;
     data.fps = 999;
@@ -102,6 +156,9 @@ DebugData DebugMonitor::createSizingDefaults()
     data.middleButton = true;
     data.rightButton = true;
     data.activeKeys = 99;
+    for (const auto& name : watchedMetrics) {
+        data.metricLines.push_back(name + ": p50 99.99 p99 99.99 max 99.99");
+    }
     return data;
 }
 
@@ -139,6 +196,27 @@ DebugData DebugMonitor::buildDebugData() const
     data.middleButton = mouseState.middleButton;
     data.rightButton = mouseState.rightButton;
     data.activeKeys = activeKeys;
+
+    for (const auto& name : watchedMetrics) {
+        Metrics::Value value;
+        if (!Metrics::find(name, value)) {
+            data.metricLines.push_back(name + ": -");
+            continue;
+        }
+        char line[128];
+        switch (value.kind) {
+        case Metrics::Kind::Counter:
+            std::snprintf(line, sizeof(line), "%s: %.0f (total %.0f)", name.c_str(), value.frame, value.total);
+            break;
+        case Metrics::Kind::Gauge:
+            std::snprintf(line, sizeof(line), "%s: %.2f", name.c_str(), value.frame);
+            break;
+        case Metrics::Kind::Histogram:
+            std::snprintf(line, sizeof(line), "%s: p50 %.2f p99 %.2f max %.2f", name.c_str(), value.p50, value.p99, value.max);
+            break;
+        }
+        data.metricLines.push_back(line);
+    }
     return data;
 }
 
@@ -163,6 +241,13 @@ std::string DebugMonitor::formatDebugText(const DebugData& data) const
         << " R:" << (data.rightButton ? "■" : "□") << "\n\n"
         << "KEYBOARD\n"
         << "  Active Keys: " << data.activeKeys << "\n";
+
+    if (!data.metricLines.empty()) {
+        oss << "\nMETRICS\n";
+        for (const auto& line : data.metricLines) {
+            oss << "  " << line << "\n";
+        }
+    }
     
     return oss.str();
 }
@@ -4,21 +4,48 @@
 #include "engine/components/renderables/primitives/RenderablePrimitive.h"
 #include "engine/components/renderables/primitives/ui/UITextBoxPrimitive.h"
 #include "engine/components/renderables/DebugData.h"
+#include "engine/core/EngineIO.h"
 #include <chrono>
 #include <string>
+#include <vector>
 
 class DebugMonitor : public UIElement {
 public:
     DebugMonitor(MTL::Device* device);
     virtual ~DebugMonitor();
-    void render(MTL::RenderCommandEncoder *encoder) override;
+    void render(DrawList *drawList) override;
+    // Refreshes the stats text at 4 Hz, low priority. Unscheduled monitors
+    // throttle themselves in render().
+    void scheduleUpdates(UpdateScheduler::Registrar registrar) override;
+
+    // Names from the Metrics registry to show under METRICS.
+    void setWatchedMetrics(const std::vector<std::string>& names);
+
+    // Re-layout only when the window size published through io changes.
+    // Without it the layout is refreshed every frame.
+    void bindIO(EngineIO& io);
 
 private:
-    static DebugData createSizingDefaults();
+    DebugData createSizingDefaults() const;
     DebugData buildDebugData() const;
     std::string formatDebugText(const DebugData& data) const;
+    void refreshStats(double elapsedSeconds);
     
     std::shared_ptr<UITextBoxPrimitive> textBox;
+    std::string currentText;
+    bool layoutDirty = true;
+    bool scheduled = false;
+
+    EngineIO* io = nullptr;
+    EngineIO::SubscriptionId widthWatch = 0;
+    EngineIO::SubscriptionId heightWatch = 0;
+    std::vector<std::string> watchedMetrics = {
+        "frame.time_ms",
+        "render.draw_calls",
+        "render.pipeline_binds",
+        "gpu.buffer_allocs",
+        "text.glyphs_built",
+    };
 
     std::chrono::steady_clock::time_point lastTick = std::chrono::steady_clock::now();
     std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
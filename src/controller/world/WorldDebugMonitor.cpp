@@ -77,27 +77,44 @@ WorldDebugMonitor::~WorldDebugMonitor()
     LOG_DESTROY("WorldDebugMonitor");
 }
 
-void WorldDebugMonitor::render(MTL::RenderCommandEncoder* encoder,
+void WorldDebugMonitor::render(DrawList* drawList,
                                 const simd::float4x4& projection,
                                 const simd::float4x4& view)
 {
-    auto now = std::chrono::steady_clock::now();
-    double dt = std::chrono::duration<double>(now - lastTick).count();
-    lastTick = now;
-    accumSeconds += dt;
     framesAccum += 1;
-    
-    if (accumSeconds >= 0.25) {
-        double instFps = framesAccum / accumSeconds;
-        smoothedFps = (smoothedFps <= 0.0) ? instFps : smoothedFps * 0.8 + instFps * 0.2;
-        
-        textBox->setText(formatDebugText(buildDebugData()));
 
-        framesAccum = 0;
-        accumSeconds = 0.0;
+    if (!scheduled) {
+        auto now = std::chrono::steady_clock::now();
+        accumSeconds += std::chrono::duration<double>(now - lastTick).count();
+        lastTick = now;
+        if (accumSeconds >= 0.25) {
+            refreshStats(accumSeconds);
+            accumSeconds = 0.0;
+        }
     }
     
-    drawPrimitives(encoder, projection, view);
+    drawPrimitives(drawList, projection, view);
+}
+
+void WorldDebugMonitor::scheduleUpdates(UpdateScheduler::Registrar registrar)
+{
+    scheduled = true;
+    registrar.addOffMain(4.0, UpdateScheduler::Priority::Low, [this](double elapsedSeconds) {
+        refreshStats(elapsedSeconds);
+    });
+}
+
+void WorldDebugMonitor::refreshStats(double elapsedSeconds)
+{
+    if (elapsedSeconds <= 0.0 || framesAccum == 0) {
+        return;
+    }
+    double instFps = framesAccum / elapsedSeconds;
+    smoothedFps = (smoothedFps <= 0.0) ? instFps : smoothedFps * 0.8 + instFps * 0.2;
+
+    textBox->setText(formatDebugText(buildDebugData()));
+
+    framesAccum = 0;
 }
 
 void WorldDebugMonitor::setMessage(const std::string& message)
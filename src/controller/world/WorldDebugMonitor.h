@@ -16,9 +16,11 @@ public:
                      float roll = 0.0f);
     virtual ~WorldDebugMonitor();
     
-    void render(MTL::RenderCommandEncoder* encoder,
+    void render(DrawList* drawList,
                 const simd::float4x4& projection,
                 const simd::float4x4& view) override;
+    // Same cadence as DebugMonitor: 4 Hz at low priority.
+    void scheduleUpdates(UpdateScheduler::Registrar registrar) override;
     
     void setMessage(const std::string& message);
 
@@ -26,8 +28,10 @@ private:
     static DebugData createSizingDefaults();
     DebugData buildDebugData() const;
     std::string formatDebugText(const DebugData& data) const;
+    void refreshStats(double elapsedSeconds);
     
     std::shared_ptr<WorldTextBoxPrimitive> textBox;
+    bool scheduled = false;
     
     std::chrono::steady_clock::time_point lastTick = std::chrono::steady_clock::now();
     std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
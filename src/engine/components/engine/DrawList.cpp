@@ -0,0 +1,185 @@
+#include "engine/components/engine/DrawList.h"
+#include "engine/core/Metrics.h"
+
+namespace {
+    template <typename T>
+    void retainIfSet(T *object)
+    {
+        if (object) object->retain();
+    }
+
+    template <typename T>
+    void releaseIfSet(T *object)
+    {
+        if (object) object->release();
+    }
+
+    template <typename T>
+    void hashValue(uint64_t &hash, const T &value)
+    {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&value);
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    }
+}
+
+DrawList::~DrawList()
+{
+    clear();
+}
+
+void DrawList::setMaterial(MTL::RenderPipelineState *pipelineState, const simd::float4 &materialColor,
+                           MTL::Texture *materialTexture, MTL::SamplerState *materialSampler)
+{
+    pipeline = pipelineState;
+    color = materialColor;
+    // Unset textures and samplers keep the previous binding, as on an encoder.
+    if (materialTexture) texture = materialTexture;
+    if (materialSampler) sampler = materialSampler;
+}
+
+void DrawList::draw(const Mesh &mesh, MTL::PrimitiveType primitiveType, const simd::float4x4 &transform,
+                    const simd::float4x4 &projection, const simd::float4x4 &view)
+{
+    if (!pipeline || (!mesh.vertexBuffer && !mesh.indexBuffer)) {
+        return;
+    }
+
+    Command command;
+    command.pipeline = pipeline;
+    command.texture = texture;
+    command.sampler = sampler;
+    command.vertexBuffer = mesh.vertexBuffer;
+    command.indexBuffer = mesh.indexBuffer;
+    command.vertexCount = (uint32_t)mesh.vertexCount;
+    command.indexCount = (uint32_t)mesh.indexCount;
+    command.primitiveType = primitiveType;
+    command.depthMode = depthMode;
+    command.depthBias = depthBias;
+    command.depthBiasSlopeScale = depthBiasSlopeScale;
+    command.color = color;
+    command.transform = transform;
+    command.projection = projection;
+    command.view = view;
+
+    retainIfSet(command.pipeline);
+    retainIfSet(command.texture);
+    retainIfSet(command.sampler);
+    retainIfSet(command.vertexBuffer);
+    retainIfSet(command.indexBuffer);
+    commands.push_back(command);
+    METRIC_COUNT("render.draw_calls", 1);
+}
+
+void DrawList::encode(MTL::RenderCommandEncoder *encoder, MTL::DepthStencilState *worldDepth,
+                      MTL::DepthStencilState *overlayDepth, std::optional<DepthMode> only) const
+{
+    MTL::RenderPipelineState *boundPipeline = nullptr;
+    MTL::Texture *boundTexture = nullptr;
+    MTL::SamplerState *boundSampler = nullptr;
+    MTL::DepthStencilState *boundDepth = nullptr;
+    // Texture and sampler in effect, including ones set by skipped commands.
+    MTL::Texture *texture = nullptr;
+    MTL::SamplerState *sampler = nullptr;
+
+    for (const Command &command : commands) {
+        if (command.texture) texture = command.texture;
+        if (command.sampler) sampler = command.sampler;
+        if (only && command.depthMode != *only) {
+            continue;
+        }
+
+        MTL::DepthStencilState *depth = command.depthMode == DepthMode::Overlay ? overlayDepth : worldDepth;
+        if (depth && depth != boundDepth) {
+            encoder->setDepthStencilState(depth);
+            boundDepth = depth;
+        }
+        if (command.pipeline != boundPipeline) {
+            encoder->setRenderPipelineState(command.pipeline);
+            boundPipeline = command.pipeline;
+            METRIC_COUNT("render.pipeline_binds", 1);
+        }
+        if (texture && texture != boundTexture) {
+            encoder->setFragmentTexture(texture, 0);
+            boundTexture = texture;
+        }
+        if (sampler && sampler != boundSampler) {
+            encoder->setFragmentSamplerState(sampler, 0);
+            boundSampler = sampler;
+        }
+        encoder->setFragmentBytes(&command.color, sizeof(simd::float4), 0);
+        encoder->setDepthBias(command.depthBias, command.depthBiasSlopeScale, 0.0f);
+
+        encoder->setVertexBytes(&command.transform, sizeof(simd::float4x4), 1);
+        encoder->setVertexBytes(&command.projection, sizeof(simd::float4x4), 2);
+        encoder->setVertexBytes(&command.view, sizeof(simd::float4x4), 3);
+        if (command.vertexBuffer) {
+            encoder->setVertexBuffer(command.vertexBuffer, 0, 0);
+        }
+
+        if (command.indexBuffer) {
+            encoder->drawIndexedPrimitives(command.primitiveType,
+                                           NS::UInteger(command.indexCount),
+                                           MTL::IndexType::IndexTypeUInt16,
+                                           command.indexBuffer,
+                                           NS::UInteger(0),
+                                           NS::UInteger(1));
+        } else {
+            encoder->drawPrimitives(command.primitiveType, NS::UInteger(0), NS::UInteger(command.vertexCount));
+        }
+    }
+}
+
+uint64_t DrawList::signature() const
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const Command &command : commands) {
+        hashValue(hash, command.pipeline);
+        hashValue(hash, command.texture);
+        hashValue(hash, command.sampler);
+        hashValue(hash, command.vertexBuffer);
+        hashValue(hash, command.indexBuffer);
+        hashValue(hash, command.vertexCount);
+        hashValue(hash, command.indexCount);
+        hashValue(hash, command.primitiveType);
+        hashValue(hash, command.depthMode);
+        hashValue(hash, command.depthBias);
+        hashValue(hash, command.depthBiasSlopeScale);
+        hashValue(hash, command.color);
+        hashValue(hash, command.transform);
+        hashValue(hash, command.projection);
+        hashValue(hash, command.view);
+    }
+    return hash;
+}
+
+void DrawList::clear()
+{
+    for (const Command &command : commands) {
+        releaseIfSet(command.pipeline);
+        releaseIfSet(command.texture);
+        releaseIfSet(command.sampler);
+        releaseIfSet(command.vertexBuffer);
+        releaseIfSet(command.indexBuffer);
+    }
+    commands.clear();
+    depthMode = DepthMode::World;
+    depthBias = 0.0f;
+    depthBiasSlopeScale = 0.0f;
+    pipeline = nullptr;
+    texture = nullptr;
+    sampler = nullptr;
+    color = simd::float4{1.0f, 1.0f, 1.0f, 1.0f};
+}
+
+void DrawList::append(DrawList &other)
+{
+    if (commands.empty()) {
+        commands.swap(other.commands);
+    } else {
+        commands.insert(commands.end(), other.commands.begin(), other.commands.end());
+        other.commands.clear();
+    }
+    other.clear();
+}
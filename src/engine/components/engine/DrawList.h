@@ -0,0 +1,76 @@
+#pragma once
+#include "engine/config.h"
+#include <optional>
+#include <vector>
+
+enum class DepthMode : uint8_t {
+    World,
+    Overlay
+};
+
+// Draws recorded by renderables and encoded later, possibly on the render
+// thread. Each command carries the full state it needs and retains the
+// Metal objects it references until clear(), so meshes and materials may
+// change or be destroyed once recording is done.
+class DrawList {
+public:
+    DrawList() = default;
+    ~DrawList();
+
+    DrawList(const DrawList&) = delete;
+    DrawList& operator=(const DrawList&) = delete;
+
+    void setDepthMode(DepthMode mode) { depthMode = mode; }
+    void setDepthBias(float bias, float slopeScale) {
+        depthBias = bias;
+        depthBiasSlopeScale = slopeScale;
+    }
+    void setMaterial(MTL::RenderPipelineState *pipeline, const simd::float4 &color,
+                     MTL::Texture *texture, MTL::SamplerState *sampler);
+
+    void draw(const Mesh &mesh, MTL::PrimitiveType primitiveType, const simd::float4x4 &transform,
+              const simd::float4x4 &projection, const simd::float4x4 &view);
+
+    // Replays the commands, skipping redundant state changes. With only
+    // set, commands recorded in the other depth mode are left out.
+    void encode(MTL::RenderCommandEncoder *encoder, MTL::DepthStencilState *worldDepth,
+                MTL::DepthStencilState *overlayDepth, std::optional<DepthMode> only = std::nullopt) const;
+
+    void clear();
+    // Moves other's commands (and the references they hold) to the end of
+    // this list and resets other.
+    void append(DrawList &other);
+    size_t size() const { return commands.size(); }
+    // Hash of every recorded command; equal signatures mean the same draws
+    // with the same state, barring buffer contents changed in place.
+    uint64_t signature() const;
+
+private:
+    struct Command {
+        MTL::RenderPipelineState *pipeline;
+        MTL::Texture *texture;
+        MTL::SamplerState *sampler;
+        MTL::Buffer *vertexBuffer;
+        MTL::Buffer *indexBuffer;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        MTL::PrimitiveType primitiveType;
+        DepthMode depthMode;
+        float depthBias;
+        float depthBiasSlopeScale;
+        simd::float4 color;
+        simd::float4x4 transform;
+        simd::float4x4 projection;
+        simd::float4x4 view;
+    };
+
+    std::vector<Command> commands;
+
+    DepthMode depthMode = DepthMode::World;
+    float depthBias = 0.0f;
+    float depthBiasSlopeScale = 0.0f;
+    MTL::RenderPipelineState *pipeline = nullptr;
+    MTL::Texture *texture = nullptr;
+    MTL::SamplerState *sampler = nullptr;
+    simd::float4 color{1.0f, 1.0f, 1.0f, 1.0f};
+};
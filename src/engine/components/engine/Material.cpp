@@ -66,7 +66,7 @@ void Material::setSampler(MTL::SamplerState *samplerState)
         sampler->retain();
 }
 
-void Material::apply(MTL::RenderCommandEncoder *encoder)
+void Material::apply(DrawList *drawList)
 {
     if (!shader) return;
     
@@ -74,16 +74,7 @@ void Material::apply(MTL::RenderCommandEncoder *encoder)
     ensureDefaultSampler();
     
     
-    encoder->setRenderPipelineState(shader->pipeline());
-
-    
-    
-    encoder->setFragmentBytes(&color, sizeof(simd::float4), 0);
-
-    if (texture)
-        encoder->setFragmentTexture(texture, 0);
-    if (sampler)
-        encoder->setFragmentSamplerState(sampler, 0);
+    drawList->setMaterial(shader->pipeline(), color, texture, sampler);
     LOG_DEBUG("Material::apply pipeline=%p tex=%p sampler=%p color=(%.2f,%.2f,%.2f,%.2f)",
               shader->pipeline(), texture, sampler, color.x, color.y, color.z, color.w);
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "engine/config.h"
+#include "engine/components/engine/DrawList.h"
 #include "engine/components/engine/Shader.h"
 
 class Material {
@@ -16,7 +17,7 @@ public:
     void setSampler(MTL::SamplerState *samplerState);
     MTL::SamplerState *getSampler() const { return sampler; }
 
-    void apply(MTL::RenderCommandEncoder *encoder);
+    void apply(DrawList *drawList);
 
 private:
     void ensureDefaultSampler();
@@ -1,5 +1,6 @@
 #include "engine/components/engine/Renderable.h"
 #include "engine/core/LogManager.h"
+#include "engine/core/Redraw.h"
 #include "engine/utils/Math.h"
 
 Renderable::Renderable(const Mesh &m, Material *mat) : mesh(m), material(mat), transform(MetalMath::identity()) {
@@ -19,36 +20,16 @@ Renderable::~Renderable()
     if (material) delete material;
 }
 
-void Renderable::draw(MTL::RenderCommandEncoder *encoder, const simd::float4x4 &projection, const simd::float4x4 &view)
+void Renderable::draw(DrawList *drawList, const simd::float4x4 &projection, const simd::float4x4 &view)
 {
     if (!material) return;
 
-    material->apply(encoder);
+    material->apply(drawList);
 
-    encoder->setDepthBias(depthBias, depthBiasSlopeScale, 0.0f);
+    drawList->setDepthBias(depthBias, depthBiasSlopeScale);
     LOG_DEBUG("Renderable::draw depthBias=%.4f slopeScale=%.4f", depthBias, depthBiasSlopeScale);
 
-    
-    encoder->setVertexBytes(&transform, sizeof(simd::float4x4), 1);
-    encoder->setVertexBytes(&projection, sizeof(simd::float4x4), 2);
-    encoder->setVertexBytes(&view, sizeof(simd::float4x4), 3);
-
-    if (mesh.vertexBuffer) {
-        encoder->setVertexBuffer(mesh.vertexBuffer, 0, 0);
-    }
-
-    if (mesh.indexBuffer) {
-        
-        encoder->drawIndexedPrimitives(primitiveType,
-                                       NS::UInteger(mesh.indexCount),
-                                       MTL::IndexType::IndexTypeUInt16,
-                                       mesh.indexBuffer,
-                                       NS::UInteger(0),
-                                       NS::UInteger(1));
-    } else if (mesh.vertexBuffer) {
-        
-        encoder->drawPrimitives(primitiveType, NS::UInteger(0), NS::UInteger(mesh.vertexCount));
-    }
+    drawList->draw(mesh, primitiveType, transform, projection, view);
 }
 
 void Renderable::updateMesh(const Mesh &m)
@@ -71,4 +52,9 @@ void Renderable::updateMesh(const Mesh &m)
     if (mesh.vertexBuffer) mesh.vertexBuffer->retain();
     if (mesh.indexBuffer) mesh.indexBuffer->retain();
     if (mesh.vertexDescriptor) mesh.vertexDescriptor->retain();
+
+    // Callers rewrite buffers in place before handing the mesh back, so the
+    // same buffers and counts can hold new contents the draw list signature
+    // can't see.
+    Redraw::request();
 }
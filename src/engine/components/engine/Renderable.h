@@ -10,7 +10,7 @@ public:
     void setTransform(const simd::float4x4 &t) { transform = t; }
     const simd::float4x4 &getTransform() const { return transform; }
 
-    void draw(MTL::RenderCommandEncoder *encoder, const simd::float4x4 &projection, const simd::float4x4 &view);
+    void draw(DrawList *drawList, const simd::float4x4 &projection, const simd::float4x4 &view);
 
     void setScreenSpace(bool v) { screenSpace = v; }
     bool isScreenSpace() const { return screenSpace; }
@@ -27,6 +27,8 @@ public:
     Material* getMaterial() { return material; }
     const Material* getMaterial() const { return material; }
 
+    // Also call after rewriting the current buffers in place; it requests a
+    // redraw so on-demand rendering picks up the new contents.
     void updateMesh(const Mesh &m);
 
 private:
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 struct DebugData {
     int fps = 0;
     double frameTimeMs = 0.0;
@@ -17,4 +20,5 @@ struct DebugData {
     bool middleButton = false;
     bool rightButton = false;
     int activeKeys = 0;
+    std::vector<std::string> metricLines;
 };
@@ -4,7 +4,7 @@ UIContainer::UIContainer() : Renderable(Mesh(), nullptr) {}
 
 UIContainer::~UIContainer() {}
 
-void UIContainer::render(MTL::RenderCommandEncoder *encoder) {
+void UIContainer::render(DrawList *drawList) {
     
     
 }
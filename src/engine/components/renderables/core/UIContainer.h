@@ -1,6 +1,7 @@
 #pragma once
 
 #include "engine/components/engine/Renderable.h"
+#include "engine/core/UpdateScheduler.h"
 
 
 class UIContainer : public Renderable {
@@ -8,5 +9,9 @@ public:
     UIContainer();
     virtual ~UIContainer();
 
-    virtual void render(MTL::RenderCommandEncoder *encoder);
+    virtual void render(DrawList *drawList);
+
+    // Called when registered with the engine; ticks added here are removed
+    // when the element is cleared.
+    virtual void scheduleUpdates(UpdateScheduler::Registrar) {}
 };
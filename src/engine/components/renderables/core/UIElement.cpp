@@ -4,6 +4,7 @@
 #include "engine/components/engine/Material.h"
 #include "engine/components/engine/Renderable.h"
 #include "engine/core/LogManager.h"
+#include "engine/core/Redraw.h"
 #include "engine/utils/Math.h"
 #include "engine/systems/input/InputState.h"
 
@@ -18,13 +19,13 @@ UIElement::~UIElement()
     destroyCachedQuad();
 }
 
-void UIElement::render(MTL::RenderCommandEncoder *encoder)
+void UIElement::render(DrawList *drawList)
 {
     const float screenWidth = InputState::getWindowWidth();
     const float screenHeight = InputState::getWindowHeight();
     transform.update(screenWidth, screenHeight);
     
-    drawPrimitives(encoder);
+    drawPrimitives(drawList);
 }
 
 void UIElement::buildCachedQuad(float left, float top, float width, float height, const simd::float4 &color)
@@ -74,6 +75,7 @@ void UIElement::moveCachedQuad(float left, float top, float width, float height)
     
     void* dst = quadMesh.vertexBuffer->contents();
     memcpy(dst, verticies, 4 * sizeof(Vertex));
+    Redraw::request();
 }
 
 void UIElement::destroyCachedQuad()
@@ -102,7 +104,7 @@ void UIElement::destroyCachedQuad()
     elementHeight = 0.0f;
 }
 
-void UIElement::drawCachedQuad(MTL::RenderCommandEncoder* encoder)
+void UIElement::drawCachedQuad(DrawList* drawList)
 {
     if (!quadRenderable) return;
     
@@ -151,9 +153,9 @@ void UIElement::drawCachedQuad(MTL::RenderCommandEncoder* encoder)
         ortho = simd_matrix(col0, col1, col2, col3);
     }
     simd::float4x4 identity = MetalMath::identity();
-    quadRenderable->draw(encoder, ortho, identity);
+    quadRenderable->draw(drawList, ortho, identity);
     
-    drawPrimitives(encoder);
+    drawPrimitives(drawList);
 }
 
 void UIElement::addPrimitive(const std::shared_ptr<RenderablePrimitive>& prim)
@@ -166,7 +168,7 @@ void UIElement::clearPrimitives()
     primitives.clear();
 }
 
-void UIElement::drawPrimitives(MTL::RenderCommandEncoder* encoder)
+void UIElement::drawPrimitives(DrawList* drawList)
 {
     if (primitives.empty()) return;
     const float screenWidth = InputState::getWindowWidth();
@@ -180,7 +182,7 @@ void UIElement::drawPrimitives(MTL::RenderCommandEncoder* encoder)
         ortho = simd_matrix(col0, col1, col2, col3);
     }
     for (auto &p : primitives) {
-        if (p) p->drawScreenSpace(encoder, ortho);
+        if (p) p->drawScreenSpace(drawList, ortho);
     }
 }
 
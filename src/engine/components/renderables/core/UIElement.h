@@ -12,11 +12,11 @@ public:
     UIElement(MTL::Device* device);
     virtual ~UIElement();
 
-    void render(MTL::RenderCommandEncoder *encoder) override;
+    void render(DrawList *drawList) override;
     
-    void drawCachedQuad(MTL::RenderCommandEncoder* encoder);
+    void drawCachedQuad(DrawList* drawList);
     
-    virtual void drawPrimitives(MTL::RenderCommandEncoder* encoder);
+    virtual void drawPrimitives(DrawList* drawList);
 
     
     void addPrimitive(const std::shared_ptr<RenderablePrimitive>& prim);
@@ -4,7 +4,7 @@ WorldContainer::WorldContainer() : Renderable(Mesh(), nullptr) {}
 
 WorldContainer::~WorldContainer() {}
 
-void WorldContainer::render(MTL::RenderCommandEncoder* encoder,
+void WorldContainer::render(DrawList* drawList,
                             const simd::float4x4& projection,
                             const simd::float4x4& view) {
 }
@@ -1,13 +1,18 @@
 #pragma once
 
 #include "engine/components/engine/Renderable.h"
+#include "engine/core/UpdateScheduler.h"
 
 class WorldContainer : public Renderable {
 public:
     WorldContainer();
     virtual ~WorldContainer();
 
-    virtual void render(MTL::RenderCommandEncoder* encoder,
+    virtual void render(DrawList* drawList,
                        const simd::float4x4& projection,
                        const simd::float4x4& view);
+
+    // Called when registered with the engine; ticks added here are removed
+    // when the element is cleared.
+    virtual void scheduleUpdates(UpdateScheduler::Registrar) {}
 };
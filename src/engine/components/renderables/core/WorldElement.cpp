@@ -12,13 +12,13 @@ WorldElement::~WorldElement()
     LOG_DESTROY("WorldElement");
 }
 
-void WorldElement::drawPrimitives(MTL::RenderCommandEncoder* encoder,
+void WorldElement::drawPrimitives(DrawList* drawList,
                                   const simd::float4x4& projection,
                                   const simd::float4x4& view)
 {
     for (auto& prim : primitives) {
         if (prim) {
-            prim->draw(encoder, projection, view);
+            prim->draw(drawList, projection, view);
         }
     }
 }
@@ -62,9 +62,9 @@ void WorldElement::getContentSize(float& width, float& height) const
     }
 }
 
-void WorldElement::render(MTL::RenderCommandEncoder* encoder,
+void WorldElement::render(DrawList* drawList,
                           const simd::float4x4& projection,
                           const simd::float4x4& view)
 {
-    drawPrimitives(encoder, projection, view);
+    drawPrimitives(drawList, projection, view);
 }
@@ -11,7 +11,7 @@ public:
     WorldElement(MTL::Device* device);
     virtual ~WorldElement();
 
-    virtual void drawPrimitives(MTL::RenderCommandEncoder* encoder,
+    virtual void drawPrimitives(DrawList* drawList,
                                const simd::float4x4& projection,
                                const simd::float4x4& view);
 
@@ -26,7 +26,7 @@ public:
 
     void getContentSize(float& width, float& height) const;
 
-    void render(MTL::RenderCommandEncoder* encoder,
+    void render(DrawList* drawList,
                 const simd::float4x4& projection,
                 const simd::float4x4& view) override;
 
@@ -2,6 +2,7 @@
 #include "engine/utils/Math.h"
 #include "engine/systems/input/InputState.h"
 #include "engine/factories/CircleFactory.h"
+#include "engine/factories/MeshFactory.h"
 
 
 CirclePrimitive::CirclePrimitive(MTL::Device *device, float x, float y, float r, const simd::float4 &col, int segs)
@@ -45,9 +46,9 @@ void CirclePrimitive::rebuild()
     }
 
     
-    mesh.vertexBuffer = device->newBuffer(vertices.size() * sizeof(Vertex), MTL::ResourceStorageModeShared);
+    mesh.vertexBuffer = MeshFactory::newBuffer(device, vertices.size() * sizeof(Vertex));
     memcpy(mesh.vertexBuffer->contents(), vertices.data(), vertices.size() * sizeof(Vertex));
-    mesh.indexBuffer = device->newBuffer(indices.size() * sizeof(ushort), MTL::ResourceStorageModeShared);
+    mesh.indexBuffer = MeshFactory::newBuffer(device, indices.size() * sizeof(ushort));
     memcpy(mesh.indexBuffer->contents(), indices.data(), indices.size() * sizeof(ushort));
     mesh.vertexCount = vertices.size();
     mesh.indexCount = indices.size();
@@ -84,14 +85,14 @@ void CirclePrimitive::rebuild()
     dirty = false;
 }
 
-void CirclePrimitive::draw(MTL::RenderCommandEncoder *encoder,
+void CirclePrimitive::draw(DrawList *drawList,
                              const simd::float4x4 &projection,
                              const simd::float4x4 &view)
 {
     rebuild();
     if (!renderable)
         return;
-    renderable->draw(encoder, projection, view);
+    renderable->draw(drawList, projection, view);
 }
 
 void CirclePrimitive::onColorChanged()
@@ -10,7 +10,7 @@ class CirclePrimitive : public RenderablePrimitive
 {
 public:
     CirclePrimitive(MTL::Device *device, float cx, float cy, float radius, const simd::float4 &col, int segments = 32);
-    void draw(MTL::RenderCommandEncoder *encoder,
+    void draw(DrawList *drawList,
               const simd::float4x4 &projection,
               const simd::float4x4 &view) override;
     void setCenter(float x, float y)
@@ -43,14 +43,14 @@ class CompositePrimitive : public RenderablePrimitive
 public:
     void add(const std::shared_ptr<RenderablePrimitive> &child) { children.push_back(child); }
     void clear() { children.clear(); }
-    void draw(MTL::RenderCommandEncoder *encoder,
+    void draw(DrawList *drawList,
               const simd::float4x4 &projection,
               const simd::float4x4 &view) override
     {
         for (auto &c : children)
         {
             if (c)
-                c->draw(encoder, projection, view);
+                c->draw(drawList, projection, view);
         }
     }
 
@@ -1,6 +1,7 @@
 #include "engine/components/renderables/primitives/2d/RectanglePrimitive.h"
 #include "engine/utils/Math.h"
 #include "engine/systems/input/InputState.h"
+#include "engine/factories/MeshFactory.h"
 #include <cmath>
 
 
@@ -46,7 +47,7 @@ void RectanglePrimitive::ensureMesh()
 
     
     if (!mesh.vertexBuffer) {
-        mesh.vertexBuffer = device->newBuffer(4 * sizeof(Vertex), MTL::ResourceStorageModeShared);
+        mesh.vertexBuffer = MeshFactory::newBuffer(device, 4 * sizeof(Vertex));
     }
     memcpy(mesh.vertexBuffer->contents(), vertices, 4 * sizeof(Vertex));
     mesh.vertexCount = 4;
@@ -55,7 +56,7 @@ void RectanglePrimitive::ensureMesh()
         size_t ibSize = indices.size() * sizeof(ushort);
         if (!mesh.indexBuffer || mesh.indexBuffer->length() < ibSize) {
             if (mesh.indexBuffer) mesh.indexBuffer->release();
-            mesh.indexBuffer = device->newBuffer(ibSize, MTL::ResourceStorageModeShared);
+            mesh.indexBuffer = MeshFactory::newBuffer(device, ibSize);
         }
         memcpy(mesh.indexBuffer->contents(), indices.data(), ibSize);
         mesh.indexCount = indices.size();
@@ -96,13 +97,13 @@ void RectanglePrimitive::ensureMesh()
     dirty = false;
 }
 
-void RectanglePrimitive::draw(MTL::RenderCommandEncoder* encoder,
+void RectanglePrimitive::draw(DrawList* drawList,
                                 const simd::float4x4 &projection,
                                 const simd::float4x4 &view)
 {
     ensureMesh();
     if (!renderable) return;
-    renderable->draw(encoder, projection, view);
+    renderable->draw(drawList, projection, view);
 }
 
 void RectanglePrimitive::onColorChanged()
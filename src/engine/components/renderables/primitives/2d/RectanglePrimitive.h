@@ -9,7 +9,7 @@
 class RectanglePrimitive : public RenderablePrimitive {
 public:
     RectanglePrimitive(MTL::Device* device, float left, float top, float width, float height, const simd::float4 &col);
-    void draw(MTL::RenderCommandEncoder* encoder,
+    void draw(DrawList* drawList,
               const simd::float4x4 &projection,
               const simd::float4x4 &view) override;
     void setPosition(float left, float top) { l = left; t = top; dirty = true; }
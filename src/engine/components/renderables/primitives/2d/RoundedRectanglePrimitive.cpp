@@ -2,6 +2,7 @@
 #include "engine/utils/Math.h"
 #include "engine/systems/input/InputState.h"
 #include "engine/factories/RoundedRectangleFactory.h"
+#include "engine/factories/MeshFactory.h"
 
 RoundedRectanglePrimitive::RoundedRectanglePrimitive(MTL::Device* device,
                                                          float left, float top,
@@ -57,9 +58,9 @@ void RoundedRectanglePrimitive::rebuild()
     }
 
     
-    mesh.vertexBuffer = device->newBuffer(vertices.size() * sizeof(Vertex), MTL::ResourceStorageModeShared);
+    mesh.vertexBuffer = MeshFactory::newBuffer(device, vertices.size() * sizeof(Vertex));
     memcpy(mesh.vertexBuffer->contents(), vertices.data(), vertices.size() * sizeof(Vertex));
-    mesh.indexBuffer = device->newBuffer(indices.size() * sizeof(ushort), MTL::ResourceStorageModeShared);
+    mesh.indexBuffer = MeshFactory::newBuffer(device, indices.size() * sizeof(ushort));
     memcpy(mesh.indexBuffer->contents(), indices.data(), indices.size() * sizeof(ushort));
     mesh.vertexCount = vertices.size();
     mesh.indexCount = indices.size();
@@ -96,13 +97,13 @@ void RoundedRectanglePrimitive::rebuild()
     dirty = false;
 }
 
-void RoundedRectanglePrimitive::draw(MTL::RenderCommandEncoder* encoder,
+void RoundedRectanglePrimitive::draw(DrawList* drawList,
                                        const simd::float4x4 &projection,
                                        const simd::float4x4 &view)
 {
     rebuild();
     if (!renderable) return;
-    renderable->draw(encoder, projection, view);
+    renderable->draw(drawList, projection, view);
 }
 
 void RoundedRectanglePrimitive::onColorChanged()
@@ -106,16 +106,16 @@ TextBoxPrimitive::TextBoxPrimitive(MTL::Device *device,
     }
 }
 
-void TextBoxPrimitive::draw(MTL::RenderCommandEncoder *encoder,
+void TextBoxPrimitive::draw(DrawList *drawList,
                              const simd::float4x4 &projection,
                              const simd::float4x4 &view)
 {
     if (background) {
-        background->draw(encoder, projection, view);
+        background->draw(drawList, projection, view);
     }
     
     if (textPrimitive) {
-        textPrimitive->draw(encoder, projection, view);
+        textPrimitive->draw(drawList, projection, view);
     }
 }
 
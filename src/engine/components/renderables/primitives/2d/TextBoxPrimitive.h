@@ -42,7 +42,7 @@ public:
                      float fontSize,
                      const TextBoxConfig &config);
     
-    void draw(MTL::RenderCommandEncoder *encoder,
+    void draw(DrawList *drawList,
               const simd::float4x4 &projection,
               const simd::float4x4 &view) override;
     
@@ -2,6 +2,8 @@
 #include "engine/core/FontManager.h"
 #include "engine/utils/Math.h"
 #include "engine/core/LogManager.h"
+#include "engine/core/Metrics.h"
+#include "engine/factories/MeshFactory.h"
 
 TextPrimitive::TextPrimitive(MTL::Device *device, 
                              const std::string &text, 
@@ -11,7 +13,7 @@ TextPrimitive::TextPrimitive(MTL::Device *device,
                              const simd::float4 &col)
     : device(device), text(text), fontPath(fontPath), x(x), y(y), fontSize(fontSize), dirty(true),
       hasBoxSize(false), boxWidth(0), boxHeight(0), alignment(TextAlign::Start), 
-      justification(TextJustify::Start), wrapEnabled(false)
+      justification(TextJustify::Start), wrapEnabled(false), layoutDirty(true)
 {
     setColor(col);
     
@@ -27,25 +29,8 @@ void TextPrimitive::rebuild()
     if (!dirty || !font || text.empty())
         return;
     
-    
-    std::vector<std::string> lines;
-    if (wrapEnabled && hasBoxSize) {
-        lines = wrapText(text, boxWidth);
-    } else {
-        
-        std::string line;
-        for (char c : text) {
-            if (c == '\n') {
-                lines.push_back(line);
-                line.clear();
-            } else {
-                line += c;
-            }
-        }
-        if (!line.empty() || lines.empty()) {
-            lines.push_back(line);
-        }
-    }
+    const TextLayout& current = ensureLayout();
+    const std::vector<std::string>& lines = current.lines;
     
     
     int visibleChars = 0;
@@ -63,7 +48,7 @@ void TextPrimitive::rebuild()
     }
     
     
-    std::vector<Vertex> vertices;
+    std::vector<GlyphVertex> vertices;
     std::vector<ushort> indices;
     vertices.reserve(visibleChars * 4);
     indices.reserve(visibleChars * 6);
@@ -92,15 +77,9 @@ void TextPrimitive::rebuild()
     int vertexIndex = 0;
     float currentY = startY;
     
-    for (const auto& line : lines) {
-        
-        float lineWidth = 0.0f;
-        for (char c : line) {
-            const BakedGlyph* glyph = font->getGlyph(c);
-            if (glyph) {
-                lineWidth += glyph->xadvance;
-            }
-        }
+    for (size_t lineIndex = 0; lineIndex < lines.size(); ++lineIndex) {
+        const std::string& line = lines[lineIndex];
+        float lineWidth = current.lineWidths[lineIndex];
         
         
         float currentX = x;
@@ -137,10 +116,11 @@ void TextPrimitive::rebuild()
             if (glyphWidth > 0 && glyphHeight > 0) {
                 
                 
-                vertices.push_back({{x0, y1, 0.0f}, {color.x, color.y, color.z}, {glyph->x0, glyph->y0}});
-                vertices.push_back({{x1, y1, 0.0f}, {color.x, color.y, color.z}, {glyph->x1, glyph->y0}});
-                vertices.push_back({{x1, y0, 0.0f}, {color.x, color.y, color.z}, {glyph->x1, glyph->y1}});
-                vertices.push_back({{x0, y0, 0.0f}, {color.x, color.y, color.z}, {glyph->x0, glyph->y1}});
+                float page = (float)glyph->page;
+                vertices.push_back({{x0, y1, 0.0f}, {color.x, color.y, color.z}, {glyph->x0, glyph->y0}, page});
+                vertices.push_back({{x1, y1, 0.0f}, {color.x, color.y, color.z}, {glyph->x1, glyph->y0}, page});
+                vertices.push_back({{x1, y0, 0.0f}, {color.x, color.y, color.z}, {glyph->x1, glyph->y1}, page});
+                vertices.push_back({{x0, y0, 0.0f}, {color.x, color.y, color.z}, {glyph->x0, glyph->y1}, page});
                 
                 
                 indices.push_back(vertexIndex + 0);
@@ -163,12 +143,13 @@ void TextPrimitive::rebuild()
         dirty = false;
         return;
     }
+    METRIC_COUNT("text.glyphs_built", vertices.size() / 4);
     
     
-    size_t vbSize = vertices.size() * sizeof(Vertex);
+    size_t vbSize = vertices.size() * sizeof(GlyphVertex);
     if (!mesh.vertexBuffer || mesh.vertexBuffer->length() < vbSize) {
         if (mesh.vertexBuffer) mesh.vertexBuffer->release();
-        mesh.vertexBuffer = device->newBuffer(vbSize, MTL::ResourceStorageModeShared);
+        mesh.vertexBuffer = MeshFactory::newBuffer(device, vbSize);
     }
     memcpy(mesh.vertexBuffer->contents(), vertices.data(), vbSize);
     mesh.vertexCount = vertices.size();
@@ -177,7 +158,7 @@ void TextPrimitive::rebuild()
     size_t ibSize = indices.size() * sizeof(ushort);
     if (!mesh.indexBuffer || mesh.indexBuffer->length() < ibSize) {
         if (mesh.indexBuffer) mesh.indexBuffer->release();
-        mesh.indexBuffer = device->newBuffer(ibSize, MTL::ResourceStorageModeShared);
+        mesh.indexBuffer = MeshFactory::newBuffer(device, ibSize);
     }
     memcpy(mesh.indexBuffer->contents(), indices.data(), ibSize);
     mesh.indexCount = indices.size();
@@ -189,21 +170,26 @@ void TextPrimitive::rebuild()
         
         auto positionDescriptor = attributes->object(0);
         positionDescriptor->setFormat(MTL::VertexFormat::VertexFormatFloat3);
-        positionDescriptor->setOffset(offsetof(Vertex, position));
+        positionDescriptor->setOffset(offsetof(GlyphVertex, position));
         positionDescriptor->setBufferIndex(0);
         
         auto colorDescriptor = attributes->object(1);
         colorDescriptor->setFormat(MTL::VertexFormat::VertexFormatFloat3);
         colorDescriptor->setBufferIndex(0);
-        colorDescriptor->setOffset(offsetof(Vertex, color));
+        colorDescriptor->setOffset(offsetof(GlyphVertex, color));
         
         auto uvDescriptor = attributes->object(2);
         uvDescriptor->setFormat(MTL::VertexFormat::VertexFormatFloat2);
         uvDescriptor->setBufferIndex(0);
-        uvDescriptor->setOffset(offsetof(Vertex, uv));
+        uvDescriptor->setOffset(offsetof(GlyphVertex, uv));
+        
+        auto pageDescriptor = attributes->object(3);
+        pageDescriptor->setFormat(MTL::VertexFormat::VertexFormatFloat);
+        pageDescriptor->setBufferIndex(0);
+        pageDescriptor->setOffset(offsetof(GlyphVertex, page));
         
         auto layoutDescriptor = vertexDescriptor->layouts()->object(0);
-        layoutDescriptor->setStride(sizeof(Vertex));
+        layoutDescriptor->setStride(sizeof(GlyphVertex));
         mesh.vertexDescriptor = vertexDescriptor;
     }
     
@@ -234,7 +220,7 @@ void TextPrimitive::ensureMesh()
     }
 }
 
-void TextPrimitive::draw(MTL::RenderCommandEncoder *encoder,
+void TextPrimitive::draw(DrawList *drawList,
                          const simd::float4x4 &projection,
                          const simd::float4x4 &view)
 {
@@ -244,14 +230,14 @@ void TextPrimitive::draw(MTL::RenderCommandEncoder *encoder,
     
     if (!renderable) return;
     
-    renderable->draw(encoder, projection, view);
+    renderable->draw(drawList, projection, view);
 }
 
 void TextPrimitive::setText(const std::string &newText)
 {
     if (text != newText) {
         text = newText;
-        dirty = true;
+        invalidateLayout();
     }
 }
 
@@ -268,7 +254,7 @@ void TextPrimitive::setFontSize(float size)
 {
     if (fontSize != size) {
         fontSize = size;
-        dirty = true;
+        invalidateLayout();
         
         font = FontManager::getInstance().getFont(fontPath, fontSize);
     }
@@ -278,7 +264,7 @@ void TextPrimitive::setFont(const std::string &newFontPath)
 {
     if (fontPath != newFontPath) {
         fontPath = newFontPath;
-        dirty = true;
+        invalidateLayout();
         font = FontManager::getInstance().getFont(fontPath, fontSize);
     }
 }
@@ -301,26 +287,42 @@ void TextPrimitive::getContentSize(float& width, float& height) const
         return;
     }
 
+    const TextLayout& current = ensureLayout();
+    width = current.width;
+    height = current.height;
+}
+
+const TextPrimitive::TextLayout& TextPrimitive::ensureLayout() const
+{
+    if (!layoutDirty) {
+        return layout;
+    }
+    
+    layout.lines.clear();
+    layout.lineWidths.clear();
+    
     if (wrapEnabled && hasBoxSize) {
-        auto lines = const_cast<TextPrimitive*>(this)->wrapText(text, boxWidth);
-        float maxLineWidth = 0.0f;
-        for (const auto& line : lines) {
-            float lineWidth = 0.0f;
-            for (char c : line) {
-                const BakedGlyph* glyph = font->getGlyph(c);
-                if (glyph) {
-                    lineWidth += glyph->xadvance;
-                }
-            }
-            if (lineWidth > maxLineWidth) {
-                maxLineWidth = lineWidth;
-            }
-        }
-        width = maxLineWidth;
-        height = lines.size() * font->getLineHeight();
+        wrapText(text, boxWidth, layout);
     } else {
-        measureText(width, height);
+        splitLines(text, layout);
+    }
+    
+    layout.width = 0.0f;
+    for (float lineWidth : layout.lineWidths) {
+        if (lineWidth > layout.width) {
+            layout.width = lineWidth;
+        }
     }
+    layout.height = layout.lines.size() * (font ? font->getLineHeight() : 0.0f);
+    
+    layoutDirty = false;
+    return layout;
+}
+
+void TextPrimitive::invalidateLayout()
+{
+    layoutDirty = true;
+    dirty = true;
 }
 
 void TextPrimitive::onColorChanged()
@@ -335,6 +337,13 @@ void TextPrimitive::onColorChanged()
 
 void TextPrimitive::setBoxSize(float width, float height)
 {
+    if (hasBoxSize && boxWidth == width && boxHeight == height) {
+        return;
+    }
+    
+    if (!hasBoxSize || boxWidth != width) {
+        layoutDirty = true;
+    }
     hasBoxSize = true;
     boxWidth = width;
     boxHeight = height;
@@ -343,8 +352,10 @@ void TextPrimitive::setBoxSize(float width, float height)
 
 void TextPrimitive::clearBoxSize()
 {
-    hasBoxSize = false;
-    dirty = true;
+    if (hasBoxSize) {
+        hasBoxSize = false;
+        invalidateLayout();
+    }
 }
 
 void TextPrimitive::setAlignment(TextAlign align)
@@ -367,14 +378,32 @@ void TextPrimitive::setWrap(bool enabled)
 {
     if (wrapEnabled != enabled) {
         wrapEnabled = enabled;
-        dirty = true;
+        invalidateLayout();
     }
 }
 
-std::vector<std::string> TextPrimitive::wrapText(const std::string& text, float maxWidth) const
+void TextPrimitive::splitLines(const std::string& text, TextLayout& layout) const
 {
-    std::vector<std::string> lines;
-    if (!font) return lines;
+    size_t start = 0;
+    for (size_t i = 0; i <= text.length(); ++i) {
+        bool atEnd = i == text.length();
+        if (!atEnd && text[i] != '\n') {
+            continue;
+        }
+        
+        if (!atEnd || i > start || layout.lines.empty()) {
+            layout.lines.emplace_back(text, start, i - start);
+            layout.lineWidths.push_back(font ? font->measureAdvance(text.data() + start, i - start) : 0.0f);
+        }
+        start = i + 1;
+    }
+}
+
+void TextPrimitive::wrapText(const std::string& text, float maxWidth, TextLayout& layout) const
+{
+    std::vector<std::string>& lines = layout.lines;
+    std::vector<float>& widths = layout.lineWidths;
+    if (!font) return;
     
     std::string currentLine;
     float currentWidth = 0.0f;
@@ -388,10 +417,12 @@ std::vector<std::string> TextPrimitive::wrapText(const std::string& text, float
         if (c == '\n') {
             if (!word.empty()) {
                 currentLine += word;
+                currentWidth += wordWidth;
                 word.clear();
                 wordWidth = 0.0f;
             }
             lines.push_back(currentLine);
+            widths.push_back(currentWidth);
             currentLine.clear();
             currentWidth = 0.0f;
             continue;
@@ -410,6 +441,7 @@ std::vector<std::string> TextPrimitive::wrapText(const std::string& text, float
                 if (currentWidth + wordWidth > maxWidth && !currentLine.empty()) {
                     
                     lines.push_back(currentLine);
+                    widths.push_back(currentWidth);
                     currentLine = word;
                     currentWidth = wordWidth;
                 } else {
@@ -437,21 +469,24 @@ std::vector<std::string> TextPrimitive::wrapText(const std::string& text, float
     if (!word.empty()) {
         if (currentWidth + wordWidth > maxWidth && !currentLine.empty()) {
             lines.push_back(currentLine);
+            widths.push_back(currentWidth);
             currentLine = word;
+            currentWidth = wordWidth;
         } else {
             currentLine += word;
+            currentWidth += wordWidth;
         }
     }
     
     
     if (!currentLine.empty()) {
         lines.push_back(currentLine);
+        widths.push_back(currentWidth);
     }
     
     
     if (lines.empty()) {
         lines.push_back("");
+        widths.push_back(0.0f);
     }
-    
-    return lines;
 }
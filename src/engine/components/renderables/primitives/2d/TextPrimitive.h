@@ -31,7 +31,7 @@ public:
                   float fontSize, 
                   const simd::float4 &col);
     
-    void draw(MTL::RenderCommandEncoder *encoder,
+    void draw(DrawList *drawList,
               const simd::float4x4 &projection,
               const simd::float4x4 &view) override;
     
@@ -62,9 +62,19 @@ public:
     void getContentSize(float& width, float& height) const override;
 
 private:
+    struct TextLayout {
+        std::vector<std::string> lines;
+        std::vector<float> lineWidths;
+        float width = 0.0f;
+        float height = 0.0f;
+    };
+    
     void rebuild();
     void ensureMesh();
-    std::vector<std::string> wrapText(const std::string& text, float maxWidth) const;
+    const TextLayout& ensureLayout() const;
+    void invalidateLayout();
+    void splitLines(const std::string& text, TextLayout& layout) const;
+    void wrapText(const std::string& text, float maxWidth, TextLayout& layout) const;
     
     MTL::Device *device;
     std::string text;
@@ -81,6 +91,9 @@ private:
     TextJustify justification;
     bool wrapEnabled;
     
+    mutable TextLayout layout;
+    mutable bool layoutDirty;
+    
     std::shared_ptr<Font> font;
     Mesh mesh{};
     std::shared_ptr<Renderable> renderable;
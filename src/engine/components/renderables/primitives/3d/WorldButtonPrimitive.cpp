@@ -18,25 +18,36 @@ WorldButtonPrimitive::WorldButtonPrimitive(MTL::Device* device,
 
     forward = simd::float3{0,0,1};
     up = simd::float3{0,1,0};
+
+    inputListener = InputEvents::addListener([this](const InputEvent& event) { onInput(event); });
 }
 
 WorldButtonPrimitive::~WorldButtonPrimitive()
 {
     LOG_DESTROY("WorldButtonPrimitive");
+    InputEvents::removeListener(inputListener);
 }
 
-void WorldButtonPrimitive::draw(MTL::RenderCommandEncoder* encoder,
+void WorldButtonPrimitive::draw(DrawList* drawList,
                                 const simd::float4x4& projection,
                                 const simd::float4x4& view)
 {
     updateTransform();
+    lastProjection = projection;
+    lastView = view;
+    hasDrawn = true;
+
+    if (button) button->draw(drawList, projection, view);
+}
 
-    const auto& mouse = InputState::getMouseState();
-    bool leftDown = mouse.leftButton;
-    float mx = mouse.x;
-    float my = mouse.y;
+void WorldButtonPrimitive::onInput(const InputEvent& event)
+{
+    const bool leftButton = event.type == InputEvent::Type::MouseButton && event.code == GLFW_MOUSE_BUTTON_LEFT;
+    if (!hasDrawn || (event.type != InputEvent::Type::CursorMove && !leftButton)) {
+        return;
+    }
 
-    bool inside = pointInProjectedRect(mx, my, projection, view);
+    bool inside = pointInProjectedRect(static_cast<float>(event.x), static_cast<float>(event.y), lastProjection, lastView);
 
     if (inside && !isHover) {
         isHover = true;
@@ -46,20 +57,19 @@ void WorldButtonPrimitive::draw(MTL::RenderCommandEncoder* encoder,
         button->setHoverVisual(false);
     }
 
-    if (leftDown && inside) {
-        if (!isPressed) {
+    if (!leftButton) {
+        return;
+    }
+    if (event.pressed) {
+        if (inside && !isPressed) {
             isPressed = true;
             button->setPressedVisual(true);
         }
-    } else {
-        if (isPressed) {
-            if (inside) button->triggerClick();
-            isPressed = false;
-            button->setPressedVisual(false);
-        }
+    } else if (isPressed) {
+        if (inside) button->triggerClick();
+        isPressed = false;
+        button->setPressedVisual(false);
     }
-
-    if (button) button->draw(encoder, projection, view);
 }
 
 void WorldButtonPrimitive::setText(const std::string& text)
@@ -2,6 +2,7 @@
 
 #include "engine/components/renderables/primitives/RenderablePrimitive.h"
 #include "engine/components/renderables/primitives/ButtonPrimitive.h"
+#include "engine/systems/input/InputEvents.h"
 #include <memory>
 #include <string>
 
@@ -16,7 +17,7 @@ public:
 
     ~WorldButtonPrimitive();
 
-    void draw(MTL::RenderCommandEncoder* encoder,
+    void draw(DrawList* drawList,
               const simd::float4x4& projection,
               const simd::float4x4& view) override;
 
@@ -33,6 +34,7 @@ public:
 
 private:
     void updateTransform();
+    void onInput(const InputEvent& event);
     bool pointInProjectedRect(float mx, float my,
                               const simd::float4x4& projection,
                               const simd::float4x4& view) const;
@@ -47,6 +49,12 @@ private:
     float worldWidth;
     float worldHeight;
 
+    // Matrices of the last draw, for hit testing events between frames.
+    simd::float4x4 lastProjection;
+    simd::float4x4 lastView;
+    bool hasDrawn = false;
+
+    InputEvents::ListenerId inputListener = 0;
     bool isHover = false;
     bool isPressed = false;
 };
@@ -47,10 +47,10 @@ void WorldCubePrimitive::rebuild()
         3, 2, 6, 6, 7, 3
     };
 
-    mesh.vertexBuffer = device->newBuffer(8 * sizeof(Vertex), MTL::ResourceStorageModeShared);
+    mesh.vertexBuffer = MeshFactory::newBuffer(device, 8 * sizeof(Vertex));
     memcpy(mesh.vertexBuffer->contents(), vertices, 8 * sizeof(Vertex));
 
-    mesh.indexBuffer = device->newBuffer(36 * sizeof(ushort), MTL::ResourceStorageModeShared);
+    mesh.indexBuffer = MeshFactory::newBuffer(device, 36 * sizeof(ushort));
     memcpy(mesh.indexBuffer->contents(), indices, 36 * sizeof(ushort));
 
     mesh.vertexCount = 8;
@@ -91,13 +91,13 @@ void WorldCubePrimitive::rebuild()
     dirty = false;
 }
 
-void WorldCubePrimitive::draw(MTL::RenderCommandEncoder *encoder,
+void WorldCubePrimitive::draw(DrawList *drawList,
                          const simd::float4x4 &projection,
                          const simd::float4x4 &view)
 {
     rebuild();
     if (renderable)
-        renderable->draw(encoder, projection, view);
+        renderable->draw(drawList, projection, view);
 }
 
 void WorldCubePrimitive::onColorChanged()
@@ -10,7 +10,7 @@ public:
     WorldCubePrimitive(MTL::Device *device, float size, const simd::float4 &col, const simd::float3 &position = simd::float3{0.0f, 0.0f, 0.0f});
     ~WorldCubePrimitive();
     
-    void draw(MTL::RenderCommandEncoder *encoder,
+    void draw(DrawList *drawList,
               const simd::float4x4 &projection,
               const simd::float4x4 &view) override;
     
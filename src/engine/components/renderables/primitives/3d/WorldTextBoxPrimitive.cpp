@@ -1,7 +1,10 @@
 #include "engine/components/renderables/primitives/3d/WorldTextBoxPrimitive.h"
 #include "engine/core/LogManager.h"
+#include "engine/systems/input/InputState.h"
 #include "engine/utils/Math.h"
 
+#include <cmath>
+
 WorldTextBoxPrimitive::WorldTextBoxPrimitive(MTL::Device* device,
                                              const std::string& text,
                                              float x, float y, float z,
@@ -14,78 +17,95 @@ WorldTextBoxPrimitive::WorldTextBoxPrimitive(MTL::Device* device,
       up{0.0f, 1.0f, 0.0f},
       worldWidth(worldWidth),
       worldHeight(worldHeight),
-      calculatedFontSize(32.0f)
+      text(text),
+      fontPath(fontPath),
+      config(config)
 {
     LOG_CONSTRUCT("WorldTextBoxPrimitive");
     
     setScreenSpace(false);
     
-    float pixelWidth = 512.0f;
-    float pixelHeight = 512.0f;
-    
-    textBox = std::make_shared<TextBoxPrimitive>(
-        device,
-        text,
-        0.0f, 0.0f,
-        pixelWidth, pixelHeight,
-        fontPath,
-        32.0f,
-        config
-    );
-    
-    textBox->setScreenSpace(false);
-    
-    updateTransform();
+    // Every level is built here, so switching LOD while recording never
+    // bakes a font size mid-frame or touches FontManager off the main
+    // thread. Levels that aren't drawn keep their text dirty and only
+    // rebuild once selected.
+    for (int i = 0; i < LOD_COUNT; ++i) {
+        levels[i] = createLevel(i);
+    }
 }
 
-void WorldTextBoxPrimitive::draw(MTL::RenderCommandEncoder* encoder,
+void WorldTextBoxPrimitive::draw(DrawList* drawList,
                                   const simd::float4x4& projection,
                                   const simd::float4x4& view)
 {
-    if (textBox) {
-        textBox->draw(encoder, projection, view);
+    selectLevel(projection, view);
+    
+    if (auto textBox = levels[activeLevel]) {
+        textBox->draw(drawList, projection, view);
     }
 }
 
-void WorldTextBoxPrimitive::setText(const std::string& text)
+void WorldTextBoxPrimitive::setText(const std::string& newText)
 {
-    if (textBox) {
-        textBox->setText(text);
+    text = newText;
+    for (auto& textBox : levels) {
+        if (textBox) {
+            textBox->setText(text);
+        }
     }
 }
 
 void WorldTextBoxPrimitive::setTextAlignment(TextAlign align)
 {
-    if (textBox) {
-        textBox->setTextAlignment(align);
+    alignment = align;
+    for (auto& textBox : levels) {
+        if (textBox) {
+            textBox->setTextAlignment(align);
+        }
     }
 }
 
 void WorldTextBoxPrimitive::setTextJustification(TextJustify justify)
 {
-    if (textBox) {
-        textBox->setTextJustification(justify);
+    justification = justify;
+    for (auto& textBox : levels) {
+        if (textBox) {
+            textBox->setTextJustification(justify);
+        }
     }
 }
 
 void WorldTextBoxPrimitive::setBackgroundColor(const simd::float4& color)
 {
-    if (textBox) {
-        textBox->setBackgroundColor(color);
+    config.backgroundColor = color;
+    for (auto& textBox : levels) {
+        if (textBox) {
+            textBox->setBackgroundColor(color);
+        }
     }
 }
 
 void WorldTextBoxPrimitive::setTextColor(const simd::float4& color)
 {
-    if (textBox) {
-        textBox->setTextColor(color);
+    config.textColor = color;
+    for (auto& textBox : levels) {
+        if (textBox) {
+            textBox->setTextColor(color);
+        }
     }
 }
 
 void WorldTextBoxPrimitive::setPadding(float left, float right, float top, float bottom)
 {
-    if (textBox) {
-        textBox->setPadding(left, right, top, bottom);
+    config.paddingLeft = left;
+    config.paddingRight = right;
+    config.paddingTop = top;
+    config.paddingBottom = bottom;
+    for (int i = 0; i < LOD_COUNT; ++i) {
+        if (levels[i]) {
+            float scale = levelPixelSize(i) / REFERENCE_PIXEL_SIZE;
+            levels[i]->setPadding(left * scale, right * scale, top * scale, bottom * scale);
+        }
     }
 }
 
@@ -111,8 +131,7 @@ void WorldTextBoxPrimitive::setOrientation(const simd::float3& newForward, const
 
 const std::string& WorldTextBoxPrimitive::getText() const
 {
-    static std::string empty;
-    return textBox ? textBox->getText() : empty;
+    return text;
 }
 
 void WorldTextBoxPrimitive::getContentSize(float& width, float& height) const
@@ -121,7 +140,12 @@ void WorldTextBoxPrimitive::getContentSize(float& width, float& height) const
     height = worldHeight;
 }
 
-void WorldTextBoxPrimitive::updateTransform()
+float WorldTextBoxPrimitive::levelPixelSize(int level) const
+{
+    return REFERENCE_PIXEL_SIZE * LOD_FONT_SIZES[level] / REFERENCE_FONT_SIZE;
+}
+
+simd::float4x4 WorldTextBoxPrimitive::levelTransform(int level) const
 {
     simd::float3 right = simd::normalize(simd::cross(up, forward));
     simd::float3 actualUp = simd::cross(forward, right);
@@ -132,17 +156,101 @@ void WorldTextBoxPrimitive::updateTransform()
     rotationMatrix.columns[2] = simd::make_float4(forward.x, forward.y, forward.z, 0.0f);
     rotationMatrix.columns[3] = simd::make_float4(0.0f, 0.0f, 0.0f, 1.0f);
     
-    float pixelSize = 512.0f;
+    float pixelSize = levelPixelSize(level);
     float scaleX = worldWidth / pixelSize;
     float scaleY = worldHeight / pixelSize;
     simd::float4x4 scaleMatrix = MetalMath::scale(scaleX, scaleY, 1.0f);
     
     simd::float4x4 translationMatrix = MetalMath::translate(position.x, position.y, position.z);
     
-    simd::float4x4 transform = translationMatrix * rotationMatrix * scaleMatrix;
+    return translationMatrix * rotationMatrix * scaleMatrix;
+}
+
+std::shared_ptr<TextBoxPrimitive> WorldTextBoxPrimitive::createLevel(int level)
+{
+    float pixelSize = levelPixelSize(level);
+    float scale = pixelSize / REFERENCE_PIXEL_SIZE;
+    
+    TextBoxConfig levelConfig = config;
+    levelConfig.paddingLeft *= scale;
+    levelConfig.paddingRight *= scale;
+    levelConfig.paddingTop *= scale;
+    levelConfig.paddingBottom *= scale;
+    levelConfig.cornerRadius *= scale;
+    
+    auto textBox = std::make_shared<TextBoxPrimitive>(
+        device,
+        text,
+        0.0f, 0.0f,
+        pixelSize, pixelSize,
+        fontPath,
+        LOD_FONT_SIZES[level],
+        levelConfig
+    );
+    
+    textBox->setScreenSpace(false);
+    textBox->setTextAlignment(alignment);
+    textBox->setTextJustification(justification);
+    textBox->setTransform(levelTransform(level));
+    
+    LOG_DEBUG("WorldTextBoxPrimitive: created LOD %d at font size %.0f", level, LOD_FONT_SIZES[level]);
+    return textBox;
+}
+
+float WorldTextBoxPrimitive::projectedFontSize(const simd::float4x4& projection, const simd::float4x4& view) const
+{
+    simd::float3 right = simd::normalize(simd::cross(up, forward));
+    simd::float3 actualUp = simd::cross(forward, right);
+    simd::float3 halfExtent = actualUp * (worldHeight * 0.5f);
+    
+    simd::float4x4 viewProjection = projection * view;
+    simd::float3 top = position + halfExtent;
+    simd::float3 bottom = position - halfExtent;
+    simd::float4 clipTop = viewProjection * simd::make_float4(top.x, top.y, top.z, 1.0f);
+    simd::float4 clipBottom = viewProjection * simd::make_float4(bottom.x, bottom.y, bottom.z, 1.0f);
+    
+    if (clipTop.w <= 0.0f || clipBottom.w <= 0.0f) {
+        return -1.0f;
+    }
+    
+    float ndcHeight = std::fabs(clipTop.y / clipTop.w - clipBottom.y / clipBottom.w);
+    float screenPixels = ndcHeight * 0.5f * InputState::getWindowHeight();
     
-    if (textBox) {
-        textBox->setTransform(transform);
+    float pixelsPerBoxPixel = screenPixels / REFERENCE_PIXEL_SIZE;
+    return REFERENCE_FONT_SIZE * pixelsPerBoxPixel;
+}
+
+void WorldTextBoxPrimitive::selectLevel(const simd::float4x4& projection, const simd::float4x4& view)
+{
+    float target = projectedFontSize(projection, view);
+    if (target <= 0.0f) {
+        return;
+    }
+    
+    int desired = LOD_COUNT - 1;
+    for (int i = 0; i < LOD_COUNT; ++i) {
+        if (LOD_FONT_SIZES[i] >= target) {
+            desired = i;
+            break;
+        }
+    }
+    
+    bool switchUp = desired > activeLevel && target > LOD_FONT_SIZES[activeLevel] * (1.0f + LOD_HYSTERESIS);
+    bool switchDown = desired < activeLevel && target < LOD_FONT_SIZES[activeLevel - 1] * (1.0f - LOD_HYSTERESIS);
+    if (!switchUp && !switchDown) {
+        return;
+    }
+    
+    LOG_DEBUG("WorldTextBoxPrimitive: LOD %d -> %d (projected font size %.1f)", activeLevel, desired, target);
+    activeLevel = desired;
+}
+
+void WorldTextBoxPrimitive::updateTransform()
+{
+    for (int i = 0; i < LOD_COUNT; ++i) {
+        if (levels[i]) {
+            levels[i]->setTransform(levelTransform(i));
+        }
     }
     
     LOG_DEBUG("WorldTextBoxPrimitive: updated transform at ({}, {}, {}) size ({}, {})",
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "engine/components/renderables/primitives/2d/TextBoxPrimitive.h"
+#include <array>
 #include <memory>
 #include <string>
 
@@ -13,7 +14,7 @@ public:
                          const std::string& fontPath,
                          const TextBoxConfig& config = TextBoxConfig{});
     
-    void draw(MTL::RenderCommandEncoder* encoder,
+    void draw(DrawList* drawList,
               const simd::float4x4& projection,
               const simd::float4x4& view) override;
     
@@ -33,18 +34,39 @@ public:
     simd::float3 getPosition() const { return position; }
     simd::float3 getForward() const { return forward; }
     simd::float3 getUp() const { return up; }
+    float getFontSize() const { return LOD_FONT_SIZES[activeLevel]; }
 
 private:
+    static constexpr int LOD_COUNT = 5;
+    static constexpr std::array<float, LOD_COUNT> LOD_FONT_SIZES = {12.0f, 16.0f, 24.0f, 32.0f, 48.0f};
+    static constexpr int DEFAULT_LOD = 3;
+    static constexpr float REFERENCE_FONT_SIZE = 32.0f;
+    static constexpr float REFERENCE_PIXEL_SIZE = 512.0f;
+    static constexpr float LOD_HYSTERESIS = 0.15f;
+    
     void updateTransform();
     void onColorChanged() override;
     void onTransformChanged() override;
     
+    float projectedFontSize(const simd::float4x4& projection, const simd::float4x4& view) const;
+    void selectLevel(const simd::float4x4& projection, const simd::float4x4& view);
+    std::shared_ptr<TextBoxPrimitive> createLevel(int level);
+    float levelPixelSize(int level) const;
+    simd::float4x4 levelTransform(int level) const;
+    
     MTL::Device* device;
     simd::float3 position;
     simd::float3 forward;
     simd::float3 up;
     float worldWidth;
     float worldHeight;
-    std::shared_ptr<TextBoxPrimitive> textBox;
-    float calculatedFontSize;
+    
+    std::string text;
+    std::string fontPath;
+    TextBoxConfig config;
+    TextAlign alignment = TextAlign::Start;
+    TextJustify justification = TextJustify::Start;
+    
+    std::array<std::shared_ptr<TextBoxPrimitive>, LOD_COUNT> levels;
+    int activeLevel = DEFAULT_LOD;
 };
@@ -60,12 +60,12 @@ ButtonPrimitive::~ButtonPrimitive()
     LOG_DESTROY("ButtonPrimitive");
 }
 
-void ButtonPrimitive::draw(MTL::RenderCommandEncoder* encoder,
+void ButtonPrimitive::draw(DrawList* drawList,
                            const simd::float4x4& projection,
                            const simd::float4x4& view)
 {
     if (textBox) {
-        textBox->draw(encoder, projection, view);
+        textBox->draw(drawList, projection, view);
     }
 }
 
@@ -11,13 +11,13 @@ class RenderablePrimitive {
 public:
     virtual ~RenderablePrimitive() = default;
 
-    virtual void draw(MTL::RenderCommandEncoder *encoder,
+    virtual void draw(DrawList *drawList,
                       const simd::float4x4 &projection,
                       const simd::float4x4 &view) = 0;
 
-    void drawScreenSpace(MTL::RenderCommandEncoder *encoder,
+    void drawScreenSpace(DrawList *drawList,
                          const simd::float4x4 &projection) {
-        draw(encoder, projection, MetalMath::identity());
+        draw(drawList, projection, MetalMath::identity());
     }
 
     void setPrimitiveType(MTL::PrimitiveType type) {
@@ -5,6 +5,7 @@
 UIButtonPrimitive::~UIButtonPrimitive()
 {
     LOG_DESTROY("UIButtonPrimitive");
+    InputEvents::removeListener(inputListener);
 }
 
 UIButtonPrimitive::UIButtonPrimitive(MTL::Device* device,
@@ -17,6 +18,7 @@ UIButtonPrimitive::UIButtonPrimitive(MTL::Device* device,
     LOG_CONSTRUCT("UIButtonPrimitive");
 
     button = std::make_shared<ButtonPrimitive>(device, text, fontPath, fontSize, config);
+    inputListener = InputEvents::addListener([this](const InputEvent& event) { onInput(event); });
 
     float w, h;
     button->underlying()->getContentSize(w, h);
@@ -35,23 +37,30 @@ UIButtonPrimitive::UIButtonPrimitive(MTL::Device* device,
     LOG_CONSTRUCT("UIButtonPrimitive");
 
     button = std::make_shared<ButtonPrimitive>(device, text, 0.0f, 0.0f, width, height, fontPath, fontSize, config);
+    inputListener = InputEvents::addListener([this](const InputEvent& event) { onInput(event); });
 
     transform.setSize(width, height);
     transform.setPosition(0.0f, 0.0f);
 }
 
-void UIButtonPrimitive::draw(MTL::RenderCommandEncoder* encoder,
+void UIButtonPrimitive::draw(DrawList* drawList,
                              const simd::float4x4& projection,
                              const simd::float4x4& view)
 {
     updatePrimitivePosition();
 
-    const auto& mouse = InputState::getMouseState();
-    bool leftDown = mouse.leftButton;
-    float mx = mouse.x;
-    float my = mouse.y;
-    float screenH = InputState::getWindowHeight();
-    float myBottomOrigin = screenH - my;
+    if (button) button->draw(drawList, projection, view);
+}
+
+void UIButtonPrimitive::onInput(const InputEvent& event)
+{
+    const bool leftButton = event.type == InputEvent::Type::MouseButton && event.code == GLFW_MOUSE_BUTTON_LEFT;
+    if (event.type != InputEvent::Type::CursorMove && !leftButton) {
+        return;
+    }
+
+    float mx = static_cast<float>(event.x);
+    float myBottomOrigin = InputState::getWindowHeight() - static_cast<float>(event.y);
 
     float x = transform.getAbsolutePosition().x;
     float y = transform.getAbsolutePosition().y;
@@ -60,9 +69,6 @@ void UIButtonPrimitive::draw(MTL::RenderCommandEncoder* encoder,
 
     bool inside = (mx >= x && mx <= x + w && myBottomOrigin >= y && myBottomOrigin <= y + h);
 
-    LOG_DEBUG("Button x={} y={} w={} h={}, mouse x={} y(top)={}, y(bottom)={}, inside={}, leftDown={}", 
-              x, y, w, h, mx, my, myBottomOrigin, inside, leftDown);
-
     if (inside && !isHover) {
         isHover = true;
         button->setHoverVisual(true);
@@ -73,22 +79,21 @@ void UIButtonPrimitive::draw(MTL::RenderCommandEncoder* encoder,
         LOG_DEBUG("Button hover OFF");
     }
 
-    if (leftDown && inside) {
-        if (!isPressed) {
+    if (!leftButton) {
+        return;
+    }
+    if (event.pressed) {
+        if (inside && !isPressed) {
             isPressed = true;
             button->setPressedVisual(true);
             LOG_DEBUG("Button pressed");
         }
-    } else {
-        if (isPressed) {
-            LOG_DEBUG("Button released, inside: {}", inside);
-            if (inside) button->triggerClick();
-            isPressed = false;
-            button->setPressedVisual(false);
-        }
+    } else if (isPressed) {
+        LOG_DEBUG("Button released, inside: {}", inside);
+        if (inside) button->triggerClick();
+        isPressed = false;
+        button->setPressedVisual(false);
     }
-
-    if (button) button->draw(encoder, projection, view);
 }
 
 void UIButtonPrimitive::setText(const std::string& text)
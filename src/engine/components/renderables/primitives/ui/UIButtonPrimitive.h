@@ -3,6 +3,7 @@
 #include "engine/components/renderables/primitives/RenderablePrimitive.h"
 #include "engine/components/renderables/core/UITransform.h"
 #include "engine/components/renderables/primitives/ButtonPrimitive.h"
+#include "engine/systems/input/InputEvents.h"
 #include <memory>
 
 class UIButtonPrimitive : public RenderablePrimitive {
@@ -22,7 +23,7 @@ public:
 
     ~UIButtonPrimitive();
 
-    void draw(MTL::RenderCommandEncoder* encoder,
+    void draw(DrawList* drawList,
               const simd::float4x4& projection,
               const simd::float4x4& view) override;
 
@@ -36,12 +37,14 @@ public:
 
 private:
     void updatePrimitivePosition();
+    void onInput(const InputEvent& event);
     void onColorChanged() override {}
 
     MTL::Device* device;
     UITransform transform;
     std::shared_ptr<ButtonPrimitive> button;
 
+    InputEvents::ListenerId inputListener = 0;
     bool isPressed = false;
     bool isHover = false;
 };
@@ -12,14 +12,14 @@ UICirclePrimitive::UICirclePrimitive(MTL::Device* device, float radius, const si
     transform.setPosition(0.0f, 0.0f);
 }
 
-void UICirclePrimitive::draw(MTL::RenderCommandEncoder* encoder,
+void UICirclePrimitive::draw(DrawList* drawList,
                               const simd::float4x4& projection,
                               const simd::float4x4& view)
 {
     updatePrimitiveTransform();
     
     if (circle) {
-        circle->draw(encoder, projection, view);
+        circle->draw(drawList, projection, view);
     }
 }
 
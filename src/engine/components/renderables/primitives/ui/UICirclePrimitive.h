@@ -8,7 +8,7 @@ class UICirclePrimitive : public RenderablePrimitive {
 public:
     UICirclePrimitive(MTL::Device* device, float radius, const simd::float4& color, int segments = 32);
     
-    void draw(MTL::RenderCommandEncoder* encoder,
+    void draw(DrawList* drawList,
               const simd::float4x4& projection,
               const simd::float4x4& view) override;
     
@@ -11,14 +11,14 @@ UIRectanglePrimitive::UIRectanglePrimitive(MTL::Device* device, float width, flo
     transform.setPosition(0.0f, 0.0f);
 }
 
-void UIRectanglePrimitive::draw(MTL::RenderCommandEncoder* encoder,
+void UIRectanglePrimitive::draw(DrawList* drawList,
                                  const simd::float4x4& projection,
                                  const simd::float4x4& view)
 {
     updatePrimitiveTransform();
     
     if (rectangle) {
-        rectangle->draw(encoder, projection, view);
+        rectangle->draw(drawList, projection, view);
     }
 }
 
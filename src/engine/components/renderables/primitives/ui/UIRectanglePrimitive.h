@@ -8,7 +8,7 @@ class UIRectanglePrimitive : public RenderablePrimitive {
 public:
     UIRectanglePrimitive(MTL::Device* device, float width, float height, const simd::float4& color);
     
-    void draw(MTL::RenderCommandEncoder* encoder,
+    void draw(DrawList* drawList,
               const simd::float4x4& projection,
               const simd::float4x4& view) override;
     
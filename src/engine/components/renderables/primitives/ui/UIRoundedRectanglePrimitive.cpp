@@ -17,14 +17,14 @@ UIRoundedRectanglePrimitive::UIRoundedRectanglePrimitive(MTL::Device* device,
     transform.setPosition(0.0f, 0.0f);
 }
 
-void UIRoundedRectanglePrimitive::draw(MTL::RenderCommandEncoder* encoder,
+void UIRoundedRectanglePrimitive::draw(DrawList* drawList,
                                         const simd::float4x4& projection,
                                         const simd::float4x4& view)
 {
     updatePrimitiveTransform();
     
     if (roundedRect) {
-        roundedRect->draw(encoder, projection, view);
+        roundedRect->draw(drawList, projection, view);
     }
 }
 
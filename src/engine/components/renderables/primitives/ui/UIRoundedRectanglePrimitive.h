@@ -12,7 +12,7 @@ public:
                                const simd::float4& color,
                                int qualityPerCorner = 6);
     
-    void draw(MTL::RenderCommandEncoder* encoder,
+    void draw(DrawList* drawList,
               const simd::float4x4& projection,
               const simd::float4x4& view) override;
     
@@ -56,14 +56,14 @@ UITextBoxPrimitive::UITextBoxPrimitive(MTL::Device* device,
     transform.setPosition(0.0f, 0.0f);
 }
 
-void UITextBoxPrimitive::draw(MTL::RenderCommandEncoder* encoder,
+void UITextBoxPrimitive::draw(DrawList* drawList,
                                const simd::float4x4& projection,
                                const simd::float4x4& view)
 {
     updatePrimitivePosition();
     
     if (textBox) {
-        textBox->draw(encoder, projection, view);
+        textBox->draw(drawList, projection, view);
     }
 }
 
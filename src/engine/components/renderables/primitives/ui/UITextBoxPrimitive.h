@@ -22,7 +22,7 @@ public:
     
     ~UITextBoxPrimitive();
     
-    void draw(MTL::RenderCommandEncoder* encoder,
+    void draw(DrawList* drawList,
               const simd::float4x4& projection,
               const simd::float4x4& view) override;
     
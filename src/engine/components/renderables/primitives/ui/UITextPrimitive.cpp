@@ -25,14 +25,14 @@ UITextPrimitive::UITextPrimitive(MTL::Device* device,
     transform.setPosition(0.0f, 0.0f);
 }
 
-void UITextPrimitive::draw(MTL::RenderCommandEncoder* encoder,
+void UITextPrimitive::draw(DrawList* drawList,
                            const simd::float4x4& projection,
                            const simd::float4x4& view)
 {
     updatePrimitivePosition();
     
     if (textPrimitive) {
-        textPrimitive->draw(encoder, projection, view);
+        textPrimitive->draw(drawList, projection, view);
     }
 }
 
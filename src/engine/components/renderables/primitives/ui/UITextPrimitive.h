@@ -13,7 +13,7 @@ public:
                    float fontSize,
                    const simd::float4& color);
     
-    void draw(MTL::RenderCommandEncoder* encoder,
+    void draw(DrawList* drawList,
               const simd::float4x4& projection,
               const simd::float4x4& view) override;
     
@@ -25,6 +25,15 @@ struct Vertex
 };
 
 
+struct GlyphVertex
+{
+    simd::float3 position;
+    simd::float3 color;
+    simd::float2 uv;
+    float page;
+};
+
+
 struct Mesh
 {
     MTL::Buffer *vertexBuffer = nullptr;
@@ -6,7 +6,11 @@
 #include "engine/components/renderables/core/WorldContainer.h"
 #include "engine/core/LogManager.h"
 #include "engine/core/FontManager.h"
+#include "engine/core/Metrics.h"
+#include "engine/core/Profiler.h"
+#include "engine/core/Redraw.h"
 #include "engine/systems/MeshRenderer.h"
+#include "engine/systems/input/InputEvents.h"
 #include "engine/systems/input/InputState.h"
 
 #include <QuartzCore/CAMetalLayer.hpp>
@@ -35,11 +39,45 @@ Engine::Engine(const EngineConfig &config)
             farPlane_(config.farPlane),
             orthographicHeight_(config.orthographicHeight),
             exitOnEscape_(config.exitOnEscape),
-            cursorMode_(config.cursorMode)
+            cursorMode_(config.cursorMode),
+            onDemandRedraw_(config.onDemandRedraw),
+            idleWaitSeconds_(config.idleWaitSeconds),
+            headless_(config.headless),
+            headlessFrameSeconds_(config.headlessFrameSeconds),
+            clock_(config.clock),
+            inputScript_(config.inputScript)
 {
+#ifdef ENABLE_PROFILER
+    PROFILE_THREAD("Main");
+    if (!config.profileTracePath.empty()) {
+        profileTracePath_ = config.profileTracePath;
+        Profiler::beginCapture(config.profileEventsPerThread);
+    }
+#endif
+
+    if (!config.binaryLogPath.empty() &&
+        !LogManager::openBinaryCapture(config.binaryLogPath.c_str(), config.binaryLogBytes)) {
+        LOG_ERROR("Engine: failed to open binary log capture %s", config.binaryLogPath.c_str());
+    }
+    if (!config.logFilePath.empty()) {
+        logFileSink_ = std::make_shared<LogManager::RotatingFileSink>(
+            config.logFilePath, config.logFileMaxBytes, config.logFileMaxAgeSeconds, config.logFileMaxFiles);
+        LogManager::addSink(logFileSink_);
+    }
+
     LOG_CONSTRUCT("Engine");
 
-    initializeGlfw(config);
+    jobs_ = std::make_unique<JobSystem>(config.jobWorkers);
+    if (!headless_) {
+        initializeGlfw(config);
+    }
+    if (!clock_) {
+        if (headless_) {
+            clock_ = [this] { return virtualTime_; };
+        } else {
+            clock_ = [] { return glfwGetTime(); };
+        }
+    }
 
     device_ = MTL::CreateSystemDefaultDevice();
     if (!device_) {
@@ -48,32 +86,36 @@ Engine::Engine(const EngineConfig &config)
     }
     
     
-    FontManager::getInstance().initialize(device_);
+    FontManager::getInstance().initialize(device_, jobs_.get(), config.glyphAtlasPages);
+
+    int winWidth = static_cast<int>(config.windowWidth);
+    int winHeight = static_cast<int>(config.windowHeight);
+    int fbWidth = winWidth;
+    int fbHeight = winHeight;
+    if (!headless_) {
+        metalLayer_ = CA::MetalLayer::layer()->retain();
+        metalLayer_->setDevice(device_);
+        metalLayer_->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm);
 
-    metalLayer_ = CA::MetalLayer::layer()->retain();
-    metalLayer_->setDevice(device_);
-    metalLayer_->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm);
+        nsWindow_ = get_ns_window(window_, metalLayer_)->retain();
 
-    nsWindow_ = get_ns_window(window_, metalLayer_)->retain();
+        glfwGetWindowSize(window_, &winWidth, &winHeight);
+        glfwGetFramebufferSize(window_, &fbWidth, &fbHeight);
+    }
 
-    renderer_ = std::make_unique<MeshRenderer>(device_, metalLayer_);
+    renderer_ = std::make_unique<MeshRenderer>(device_, metalLayer_, config.renderLatencyFrames);
 
-    int winWidth = 0;
-    int winHeight = 0;
-    glfwGetWindowSize(window_, &winWidth, &winHeight);
     windowWidth_ = static_cast<float>(winWidth);
     windowHeight_ = static_cast<float>(winHeight);
     InputState::initialize(windowWidth_, windowHeight_);
 
-    int fbWidth = 0;
-    int fbHeight = 0;
-    glfwGetFramebufferSize(window_, &fbWidth, &fbHeight);
     framebufferWidth_ = static_cast<float>(fbWidth);
     framebufferHeight_ = static_cast<float>(fbHeight);
     updateDrawableSize();
 
     if (renderer_) {
         renderer_->setOrthoParams(0.0f, windowWidth_, 0.0f, windowHeight_, -1.0f, 1.0f);
+        renderer_->setSkipUnchangedFrames(onDemandRedraw_);
     }
 
     projectionToggleEnabled_ = config.enableDefaultCameraController;
@@ -96,14 +138,45 @@ Engine::Engine(const EngineConfig &config)
     updateProjectionMatrix();
     updateCamera(0.0);
 
-    lastFrameTime_ = glfwGetTime();
+    if (config.historyFrames > 0) {
+        ioChannel_.track(IOKeys::TimeDelta, config.historyFrames);
+        ioChannel_.track(IOKeys::RenderDrawCalls, config.historyFrames);
+        historyDumpPath_ = config.historyDumpPath;
+    }
+
+    frameGraphDotPath_ = config.frameGraphDotPath;
+    setFixedTimestep(config.fixedTimestep, config.maxFixedSteps);
+    updates_.setBudget(config.updateBudgetSeconds);
+    workerUpdates_.setBudget(config.updateBudgetSeconds);
+    pacer_.setTarget(config.targetFrameSeconds);
+    renderer_->setPresentHandler(pacer_.presentRecorder());
+    if (config.dynamicResolution) {
+        renderer_->setDynamicResolution(true, pacer_.budget(), config.minResolutionScale);
+    }
+    buildFrameGraph();
+
+    lastFrameTime_ = clock_();
 }
 
 Engine::~Engine()
 {
     LOG_DESTROY("Engine");
-    uiElements_.clear();
-    worldElements_.clear();
+    if (!profileTracePath_.empty()) {
+        Profiler::endCapture();
+        Profiler::writeChromeTrace(profileTracePath_.c_str());
+    }
+    if (!historyDumpPath_.empty()) {
+        if (historyDumpPath_.ends_with(".bin")) {
+            writeHistoryBinary(historyDumpPath_.c_str(), ioChannel_.histories());
+        } else {
+            writeHistoryCsv(historyDumpPath_.c_str(), ioChannel_.histories());
+        }
+    }
+    if (!frameGraphDotPath_.empty()) {
+        frameGraph_.writeDot(frameGraphDotPath_.c_str());
+    }
+    clearUI();
+    clearWorld();
     renderer_.reset();
     FontManager::getInstance().shutdown();
     if (metalLayer_) {
@@ -119,6 +192,8 @@ Engine::~Engine()
         glfwSetWindowSizeCallback(window_, nullptr);
         glfwSetFramebufferSizeCallback(window_, nullptr);
         glfwSetKeyCallback(window_, nullptr);
+        glfwSetCursorPosCallback(window_, nullptr);
+        glfwSetMouseButtonCallback(window_, nullptr);
         glfwDestroyWindow(window_);
         window_ = nullptr;
     }
@@ -126,7 +201,15 @@ Engine::~Engine()
         nsWindow_->release();
         nsWindow_ = nullptr;
     }
-    glfwTerminate();
+    if (!headless_) {
+        glfwTerminate();
+    }
+    LogManager::closeBinaryCapture();
+    if (logFileSink_) {
+        LogManager::flush();
+        LogManager::removeSink(logFileSink_);
+        logFileSink_.reset();
+    }
 }
 
 void Engine::initializeGlfw(const EngineConfig &config)
@@ -175,6 +258,17 @@ void Engine::installCallbacks()
             engine->onKeyEvent(key, pressed);
         }
     });
+
+    glfwSetCursorPosCallback(window_, [](GLFWwindow *, double x, double y) {
+        InputEvents::pushCursor(x, y);
+    });
+
+    glfwSetMouseButtonCallback(window_, [](GLFWwindow *win, int button, int action, int) {
+        double x = 0.0;
+        double y = 0.0;
+        glfwGetCursorPos(win, &x, &y);
+        InputEvents::pushMouseButton(button, action == GLFW_PRESS, x, y);
+    });
 }
 
 void Engine::run(const FrameCallback &frameCallback)
@@ -187,40 +281,191 @@ void Engine::run(const FrameCallback &frameCallback)
 
 bool Engine::pumpFrame(const FrameCallback &frameCallback)
 {
-    if (!window_ || !renderer_) {
+    if ((!window_ && !headless_) || !renderer_) {
         return false;
     }
 
-    if (shouldClose_ || glfwWindowShouldClose(window_)) {
+    if (shouldClose_ || (window_ && glfwWindowShouldClose(window_))) {
         return false;
     }
 
-    glfwPollEvents();
-    updateInputState();
+    PROFILE_FRAME();
+    PROFILE_SCOPE("Engine::pumpFrame");
+    pacer_.beginFrame();
 
-    const double now = glfwGetTime();
+    if (headless_) {
+        virtualTime_ += headlessFrameSeconds_;
+    }
+    const double now = clock_();
     const double delta = now - lastFrameTime_;
     lastFrameTime_ = now;
 
-    updateCamera(delta);
+    FrameContext context{now, delta, ioChannel_, window_, *renderer_, *this, cameraMatrices_};
+    frameContext_ = &context;
+    frameCallback_ = &frameCallback;
+    frameGraph_.execute(*jobs_);
+    frameContext_ = nullptr;
+    frameCallback_ = nullptr;
+    ++frameIndex_;
+    pacer_.endFrame(renderer_->lastBlockedSeconds());
 
-    ioChannel_.set("time.absolute", now);
-    ioChannel_.set("time.delta", delta);
-    ioChannel_.set("window.width", windowWidth_);
-    ioChannel_.set("window.height", windowHeight_);
-    ioChannel_.set("camera.position", cameraController_.position);
-    ioChannel_.set("camera.yaw.deg", cameraController_.yawDegrees);
-    ioChannel_.set("camera.pitch.deg", cameraController_.pitchDegrees);
+    return !(shouldClose_ || (window_ && glfwWindowShouldClose(window_)));
+}
 
-    FrameContext context{now, delta, ioChannel_, window_, *renderer_, *this, cameraMatrices_};
+uint64_t Engine::pumpFrames(uint64_t count, const FrameCallback &frameCallback)
+{
+    const uint64_t start = frameIndex_;
+    while (frameIndex_ - start < count && pumpFrame(frameCallback)) {
+    }
+    return frameIndex_ - start;
+}
+
+// Phases that touch GLFW, EngineIO writes, user callbacks or Metal
+// submission stay on the main thread. Camera math and off-main element
+// ticks touch CPU state ordered by their resources. Draw recording also
+// allocates mesh buffers (MTLDevice is thread-safe) but relies on elements
+// creating fonts and text primitives up front, since FontManager is
+// main-thread only; see MeshRenderer::recordWorld.
+void Engine::buildFrameGraph()
+{
+    using namespace FrameResources;
+
+    frameGraph_.add({"PollEvents", {}, {Input}, [this] {
+        PROFILE_SCOPE("PollEvents");
+        if (window_) {
+            if (onDemandRedraw_ && !lastFrameDrawn_ && !Redraw::pending()) {
+                PROFILE_SCOPE("WaitEvents");
+                glfwWaitEventsTimeout(idleWaitSeconds_);
+            } else {
+                glfwPollEvents();
+            }
+            updateInputState();
+        } else if (inputScript_) {
+            inputScript_(frameIndex_, frameContext_->absoluteTime);
+        }
+        if (InputEvents::dispatch() > 0) {
+            Redraw::request();
+        }
+    }, true});
+
+    frameGraph_.add({"Camera", {Input}, {Camera}, [this] {
+        updateCamera(frameContext_->deltaTime);
+    }});
+
+    frameGraph_.add({"PublishFrameState", {Input, Camera}, {IO}, [this] {
+        ioChannel_.set(IOKeys::TimeAbsolute, frameContext_->absoluteTime);
+        ioChannel_.set(IOKeys::TimeDelta, frameContext_->deltaTime);
+        ioChannel_.set(IOKeys::WindowWidth, windowWidth_);
+        ioChannel_.set(IOKeys::WindowHeight, windowHeight_);
+        ioChannel_.set(IOKeys::CameraPosition, cameraController_.position);
+        ioChannel_.set(IOKeys::CameraYawDeg, cameraController_.yawDegrees);
+        ioChannel_.set(IOKeys::CameraPitchDeg, cameraController_.pitchDegrees);
+    }, true});
+
+    frameGraph_.add({"FixedUpdate", {Input, Camera}, {IO, Scene}, [this] {
+        runFixedUpdates();
+    }, true});
+
+    frameGraph_.add({"FrameCallback", {Input, Camera}, {IO, Scene}, [this] {
+        if (*frameCallback_) {
+            PROFILE_SCOPE("FrameCallback");
+            (*frameCallback_)(*frameContext_);
+        }
+    }, true});
+
+    frameGraph_.add({"IOChanges", {}, {IO, UI}, [this] {
+        ioChannel_.dispatchChanges();
+    }, true});
+
+    frameGraph_.add({"ElementUpdates", {Input, IO}, {Scene, UI}, [this] {
+        PROFILE_SCOPE("ElementUpdates");
+        updates_.setShedding(pacer_.pressure() > 1.0);
+        updates_.update(frameContext_->absoluteTime);
+    }, true});
+
+    // Runs alongside ElementUpdates, so main-thread ticks must not register
+    // or clear elements while the worker ticks run.
+    frameGraph_.add({"WorkerElementUpdates", {Input, IO}, {Elements}, [this] {
+        PROFILE_SCOPE("WorkerElementUpdates");
+        workerUpdates_.setShedding(pacer_.pressure() > 1.0);
+        workerUpdates_.update(frameContext_->absoluteTime);
+    }});
+
+    frameGraph_.add({"RecordWorld", {Camera, Scene, Elements}, {WorldDraws}, [this] {
+        renderer_->recordWorld(cameraMatrices_, worldElements_);
+    }});
+
+    // UI elements poll EngineIO watches while recording.
+    frameGraph_.add({"RecordUI", {Input, IO, UI, Elements}, {UIDraws}, [this] {
+        renderer_->recordUI(uiElements_);
+    }});
+
+    frameGraph_.add({"Render", {WorldDraws, UIDraws}, {Gpu}, [this] {
+        lastFrameDrawn_ = renderer_->submit();
+    }, true});
+
+    frameGraph_.add({"FrameStats", {Gpu}, {IO}, [this] {
+        METRIC_HISTOGRAM("frame.time_ms", frameContext_->deltaTime * 1000.0);
+        METRIC_GAUGE("frame.renderables", (double)renderer_->renderableCount());
+        Metrics::endFrame();
+
+        static const Metrics::Counter drawCalls = Metrics::counter("render.draw_calls");
+        ioChannel_.set(IOKeys::RenderDrawCalls, (uint32_t)drawCalls.frameValue());
+        ioChannel_.set(IOKeys::FramePressure, (float)pacer_.pressure());
+        ioChannel_.set(IOKeys::RenderResolutionScale, renderer_->resolutionScale());
+        METRIC_GAUGE("frame.present_jitter_ms", pacer_.presentStats().jitterSeconds * 1000.0);
+        ioChannel_.sampleHistory(frameContext_->absoluteTime);
+        ioChannel_.publish();
+    }, true});
+}
+
+void Engine::runFixedUpdates()
+{
+    if (fixedTimestep_ <= 0.0) {
+        return;
+    }
+
+    fixedAccumulator_ += frameContext_->deltaTime;
+    const double maxBacklog = fixedTimestep_ * maxFixedSteps_;
+    if (fixedAccumulator_ > maxBacklog) {
+        METRIC_HISTOGRAM("frame.fixed_dropped_ms", (fixedAccumulator_ - maxBacklog) * 1000.0);
+        fixedAccumulator_ = maxBacklog;
+    }
 
-    if (frameCallback) {
-        frameCallback(context);
+    PROFILE_SCOPE("FixedUpdate");
+    unsigned steps = 0;
+    while (fixedAccumulator_ >= fixedTimestep_) {
+        fixedTime_ += fixedTimestep_;
+        fixedAccumulator_ -= fixedTimestep_;
+        ++steps;
+        if (fixedUpdate_) {
+            FrameContext step{fixedTime_, fixedTimestep_, ioChannel_, window_, *renderer_, *this, cameraMatrices_};
+            fixedUpdate_(step);
+        }
     }
+    METRIC_COUNT("frame.fixed_steps", steps);
+
+    frameContext_->interpolation = fixedAccumulator_ / fixedTimestep_;
+}
+
+void Engine::setFixedTimestep(double seconds, unsigned maxSteps)
+{
+    fixedTimestep_ = seconds > 0.0 ? seconds : 0.0;
+    maxFixedSteps_ = std::max(maxSteps, 1u);
+    fixedAccumulator_ = 0.0;
+}
 
-    renderer_->draw(cameraMatrices_, uiElements_, worldElements_);
+void Engine::addSystem(const std::string &name, std::vector<std::string> reads, std::vector<std::string> writes,
+                       System system, bool mainThread)
+{
+    frameGraph_.addBefore("IOChanges", {name, std::move(reads), std::move(writes), [this, system = std::move(system)] {
+        system(*frameContext_);
+    }, mainThread});
+}
 
-    return !(shouldClose_ || glfwWindowShouldClose(window_));
+void Engine::removeSystem(const std::string &name)
+{
+    frameGraph_.remove(name);
 }
 
 void Engine::stop()
@@ -251,10 +496,15 @@ void Engine::registerUIElement(const std::shared_ptr<UIContainer> &element)
         return;
     }
     uiElements_.push_back(element);
+    element->scheduleUpdates(UpdateScheduler::Registrar(updates_, element.get(), &workerUpdates_));
 }
 
 void Engine::clearUI()
 {
+    for (const auto &element : uiElements_) {
+        updates_.removeOwner(element.get());
+        workerUpdates_.removeOwner(element.get());
+    }
     uiElements_.clear();
 }
 
@@ -264,10 +514,15 @@ void Engine::registerWorldElement(const std::shared_ptr<WorldContainer> &element
         return;
     }
     worldElements_.push_back(element);
+    element->scheduleUpdates(UpdateScheduler::Registrar(updates_, element.get(), &workerUpdates_));
 }
 
 void Engine::clearWorld()
 {
+    for (const auto &element : worldElements_) {
+        updates_.removeOwner(element.get());
+        workerUpdates_.removeOwner(element.get());
+    }
     worldElements_.clear();
 }
 
@@ -342,6 +597,7 @@ void Engine::updateInputState()
 
 void Engine::onWindowSizeChanged(int width, int height)
 {
+    Redraw::request();
     windowWidth_ = static_cast<float>(width);
     windowHeight_ = static_cast<float>(height);
     InputState::setWindowSize(windowWidth_, windowHeight_);
@@ -353,6 +609,7 @@ void Engine::onWindowSizeChanged(int width, int height)
 
 void Engine::onFramebufferSizeChanged(int width, int height)
 {
+    Redraw::request();
     framebufferWidth_ = static_cast<float>(width);
     framebufferHeight_ = static_cast<float>(height);
     updateDrawableSize();
@@ -362,6 +619,7 @@ void Engine::onKeyEvent(int key, bool pressed)
 {
     if (key >= 0 && key < GLFW_KEY_LAST) {
         InputState::updateKeyboard(key, pressed);
+        InputEvents::pushKey(key, pressed);
     }
 }
 
@@ -3,6 +3,12 @@
 #include "engine/config.h"
 #include "engine/core/Camera.h"
 #include "engine/core/EngineIO.h"
+#include "engine/core/FramePacer.h"
+#include "engine/core/GlyphAtlas.h"
+#include "engine/core/JobSystem.h"
+#include "engine/core/Profiler.h"
+#include "engine/core/TaskGraph.h"
+#include "engine/core/UpdateScheduler.h"
 
 #include <functional>
 #include <memory>
@@ -14,6 +20,10 @@ class Renderable;
 class UIContainer;
 class WorldContainer;
 
+namespace LogManager {
+class LogSink;
+}
+
 enum class CursorMode {
     Normal,
     Hidden,
@@ -39,8 +49,90 @@ struct EngineConfig {
     float cameraMouseSensitivity = 0.1f;
     ProjectionType cameraProjectionMode = ProjectionType::Perspective;
     float cameraOrthographicHeight = 20.0f;
+    // When set, log records are written in binary form to this file and
+    // decoded offline with tools/logdecode instead of printed.
+    std::string binaryLogPath;
+    size_t binaryLogBytes = 64 * 1024 * 1024;
+    // When set, text logs are also written to this file, rotated by size
+    // and age (zero disables a limit).
+    std::string logFilePath;
+    size_t logFileMaxBytes = 8 * 1024 * 1024;
+    double logFileMaxAgeSeconds = 0.0;
+    int logFileMaxFiles = 4;
+    // With ENABLE_PROFILER, the session is captured and written here as
+    // Chrome trace JSON when the engine is destroyed. Each thread keeps its
+    // most recent profileEventsPerThread zones (40 bytes each); the default
+    // covers roughly the last minute of main-thread frames at 60 fps.
+    std::string profileTracePath;
+    size_t profileEventsPerThread = Profiler::DEFAULT_EVENTS_PER_THREAD;
+    // When nonzero, time.delta and render.draw_calls keep this many
+    // per-frame samples in EngineIO histories. If historyDumpPath is set
+    // they are written there on shutdown (binary for a .bin path, else CSV).
+    size_t historyFrames = 0;
+    std::string historyDumpPath;
+    // 1024x1024 pages in the shared glyph atlas, allocated up front.
+    int glyphAtlasPages = GlyphAtlas::DEFAULT_MAX_PAGES;
+    // Job system worker threads; 0 uses one per hardware thread beyond the
+    // main thread.
+    unsigned jobWorkers = 0;
+    // When set, the frame task graph is written here as Graphviz DOT (with
+    // the last frame's task times) on shutdown.
+    std::string frameGraphDotPath;
+    // Frames the main thread may record ahead of a dedicated render thread
+    // (1 or 2). 0 encodes and submits on the main thread.
+    unsigned renderLatencyFrames = 0;
+    // When nonzero, the fixed update (setFixedUpdate) runs at this step in
+    // seconds, at most maxFixedSteps times per frame; time beyond that is
+    // dropped so a slow frame can't snowball into slower ones.
+    double fixedTimestep = 0.0;
+    unsigned maxFixedSteps = 5;
+    // Headless runs create no window, layer or display connection: frames
+    // are recorded but not presented, input comes only from inputScript and
+    // window size from windowWidth/windowHeight. Unless a clock is given,
+    // time is virtual and advances headlessFrameSeconds per frame, so runs
+    // are reproducible.
+    bool headless = false;
+    // When set, the loop sleeps in glfwWaitEventsTimeout (up to
+    // idleWaitSeconds) after a frame that drew nothing new, and frames whose
+    // draw list is unchanged are not submitted. Animations that rewrite
+    // buffers in place should hold Redraw::beginContinuous while running.
+    bool onDemandRedraw = false;
+    double idleWaitSeconds = 0.5;
+    // Per-frame time for scheduled element ticks before Normal and Low
+    // priority ones are deferred; 0 runs every due tick.
+    double updateBudgetSeconds = 0.0;
+    // Caps the frame rate (seconds per frame; 0 uncapped). The same value is
+    // the frame budget behind FramePacer::pressure() and the
+    // frame.pressure IO key, used to shed optional work.
+    double targetFrameSeconds = 0.0;
+    // Renders the world pass at a reduced scale (down to
+    // minResolutionScale) when GPU frame time exceeds the frame budget,
+    // upscaled to the drawable; UI stays at native resolution.
+    bool dynamicResolution = false;
+    float minResolutionScale = 0.5f;
+    double headlessFrameSeconds = 1.0 / 60.0;
+    // Seconds; replaces glfwGetTime when set.
+    std::function<double()> clock;
+    // Called in place of event polling with the frame index and time; feed
+    // InputState and InputEvents from it.
+    std::function<void(uint64_t frame, double time)> inputScript;
 };
 
+// Resources the engine's frame phases declare in the frame graph. Systems
+// name these (or their own) so they are ordered against the engine.
+namespace FrameResources {
+inline constexpr const char *Input = "input";
+inline constexpr const char *Camera = "camera";
+inline constexpr const char *IO = "io";
+inline constexpr const char *Scene = "scene";
+inline constexpr const char *UI = "ui";
+inline constexpr const char *Gpu = "gpu";
+// Element state written by off-main ticks, and the recorded draw lists.
+inline constexpr const char *Elements = "elements";
+inline constexpr const char *WorldDraws = "world_draws";
+inline constexpr const char *UIDraws = "ui_draws";
+}
+
 class Engine {
 public:
     struct FrameContext {
@@ -51,9 +143,14 @@ public:
         MeshRenderer &renderer;
         Engine &engine;
         const CameraMatrices &camera;
+        // Fraction of a fixed step left over after this frame's fixed
+        // updates, for blending previous and current simulation state when
+        // drawing. 1 when no fixed timestep is set.
+        double interpolation = 1.0;
     };
 
     using FrameCallback = std::function<void(FrameContext&)>;
+    using System = std::function<void(FrameContext&)>;
 
     explicit Engine(const EngineConfig &config);
     ~Engine();
@@ -65,9 +162,17 @@ public:
 
     void run(const FrameCallback &frameCallback);
     bool pumpFrame(const FrameCallback &frameCallback);
+    // Pumps up to count frames; returns how many ran before the engine stopped.
+    uint64_t pumpFrames(uint64_t count, const FrameCallback &frameCallback);
 
     void stop();
 
+    // Runs before the frame callback with deltaTime set to the fixed step;
+    // absoluteTime is simulation time, advancing by whole steps from zero.
+    void setFixedUpdate(const FrameCallback &fixedUpdate) { fixedUpdate_ = fixedUpdate; }
+    void setFixedTimestep(double seconds, unsigned maxSteps);
+    double fixedTimestep() const { return fixedTimestep_; }
+
     void addRenderable(const std::shared_ptr<Renderable> &renderable);
     void clearRenderables();
 
@@ -80,11 +185,28 @@ public:
     EngineIO& io() { return ioChannel_; }
     const EngineIO& io() const { return ioChannel_; }
 
+    JobSystem& jobs() { return *jobs_; }
+    UpdateScheduler& updates() { return updates_; }
+    // Ticks elements register with addOffMain; updated on a worker.
+    UpdateScheduler& workerUpdates() { return workerUpdates_; }
+    FramePacer& pacer() { return pacer_; }
+
+    // Adds a per-frame system to the frame graph. It runs after the frame
+    // callback where their resources conflict, and before change dispatch
+    // and rendering; systems with disjoint resources run concurrently on
+    // worker threads unless mainThread is set.
+    void addSystem(const std::string &name, std::vector<std::string> reads, std::vector<std::string> writes,
+                   System system, bool mainThread = false);
+    void removeSystem(const std::string &name);
+    const TaskGraph& frameGraph() const { return frameGraph_; }
+
     MTL::Device* device() const { return device_; }
     MeshRenderer& renderer();
     const MeshRenderer& renderer() const;
 
     GLFWwindow* window() const { return window_; }
+    bool headless() const { return headless_; }
+    uint64_t frameIndex() const { return frameIndex_; }
 
     float aspectRatio() const;
 
@@ -113,6 +235,8 @@ private:
     void onFramebufferSizeChanged(int width, int height);
     void onKeyEvent(int key, bool pressed);
     void updateDrawableSize();
+    void buildFrameGraph();
+    void runFixedUpdates();
 
     struct CameraControllerState {
         bool enabled = true;
@@ -125,6 +249,7 @@ private:
         ProjectionType projection = ProjectionType::Perspective;
     };
 
+    std::unique_ptr<JobSystem> jobs_;
     GLFWwindow *window_ = nullptr;
     MTL::Device *device_ = nullptr;
     CA::MetalLayer *metalLayer_ = nullptr;
@@ -133,6 +258,21 @@ private:
     std::vector<std::shared_ptr<UIContainer>> uiElements_;
     std::vector<std::shared_ptr<WorldContainer>> worldElements_;
     EngineIO ioChannel_;
+    std::shared_ptr<LogManager::LogSink> logFileSink_;
+    std::string profileTracePath_;
+    std::string historyDumpPath_;
+    TaskGraph frameGraph_;
+    UpdateScheduler updates_;
+    UpdateScheduler workerUpdates_;
+    FramePacer pacer_;
+    FrameContext *frameContext_ = nullptr;
+    const FrameCallback *frameCallback_ = nullptr;
+    std::string frameGraphDotPath_;
+    FrameCallback fixedUpdate_;
+    double fixedTimestep_ = 0.0;
+    unsigned maxFixedSteps_ = 5;
+    double fixedAccumulator_ = 0.0;
+    double fixedTime_ = 0.0;
 
     ProjectionType defaultProjectionMode_ = ProjectionType::Perspective;
     float perspectiveFovY_ = 60.0f;
@@ -147,6 +287,15 @@ private:
     bool projectionToggleEnabled_ = true;
     bool orthoScaleKeysEnabled_ = true;
 
+    bool onDemandRedraw_ = false;
+    double idleWaitSeconds_ = 0.5;
+    bool lastFrameDrawn_ = true;
+    bool headless_ = false;
+    double headlessFrameSeconds_ = 1.0 / 60.0;
+    double virtualTime_ = 0.0;
+    std::function<double()> clock_;
+    std::function<void(uint64_t, double)> inputScript_;
+    uint64_t frameIndex_ = 0;
     double lastFrameTime_ = 0.0;
     bool shouldClose_ = false;
     bool exitOnEscape_ = true;
@@ -1,45 +1,614 @@
 #pragma once
 
+#include "engine/core/IOHistory.h"
+
+#include <simd/simd.h>
+
+#include <algorithm>
 #include <any>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+constexpr uint64_t ioKeyHash(std::string_view name)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : name) {
+        hash = (hash ^ (uint8_t)c) * 1099511628211ull;
+    }
+    // 0 and ~0 mark empty and erased slots in EngineIO.
+    return (hash == 0 || hash == ~0ull) ? 1 : hash;
+}
 
+// A typed key whose hash is computed at compile time. Values stored through
+// an IOKey live in a flat slot table with inline storage, so set/get do no
+// allocation, string hashing or exception handling.
+template <typename T>
+struct IOKey {
+    constexpr explicit IOKey(const char *name) : name(name), hash(ioKeyHash(name)) {}
+
+    const char *name;
+    uint64_t hash;
+};
+
+namespace IOKeys {
+inline constexpr IOKey<double> TimeAbsolute{"time.absolute"};
+inline constexpr IOKey<double> TimeDelta{"time.delta"};
+inline constexpr IOKey<float> WindowWidth{"window.width"};
+inline constexpr IOKey<float> WindowHeight{"window.height"};
+inline constexpr IOKey<simd::float3> CameraPosition{"camera.position"};
+inline constexpr IOKey<float> CameraYawDeg{"camera.yaw.deg"};
+inline constexpr IOKey<float> CameraPitchDeg{"camera.pitch.deg"};
+inline constexpr IOKey<uint32_t> RenderDrawCalls{"render.draw_calls"};
+inline constexpr IOKey<float> FramePressure{"frame.pressure"};
+inline constexpr IOKey<float> RenderResolutionScale{"render.resolution_scale"};
+}
 
 class EngineIO {
+    struct Slot;
+    struct SnapshotBuffer;
+
 public:
-    EngineIO() = default;
+    static constexpr size_t INLINE_BYTES = 64;
+
+    using SubscriptionId = uint32_t;
+
+    // A pinned, immutable copy of the typed values as of the last publish().
+    // Holding one never blocks the publishing thread; it only keeps that
+    // buffer from being reused. Must not outlive the EngineIO.
+    class Snapshot {
+    public:
+        Snapshot() = default;
+        Snapshot(Snapshot &&other) noexcept : buffer_(std::exchange(other.buffer_, nullptr)) {}
+        Snapshot &operator=(Snapshot &&other) noexcept {
+            if (this != &other) {
+                release();
+                buffer_ = std::exchange(other.buffer_, nullptr);
+            }
+            return *this;
+        }
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+        ~Snapshot() { release(); }
+
+        explicit operator bool() const { return buffer_ != nullptr; }
+        uint64_t frame() const;
+
+        template <typename T>
+        std::optional<T> get(const IOKey<T> &key) const {
+            T value;
+            if (!buffer_ || !readSlot(buffer_->slots, key.hash, typeId<T>(), &value, sizeof(T))) {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        template <typename T>
+        std::optional<T> get(const std::string &key) const {
+            return get(IOKey<T>{key.c_str()});
+        }
+
+    private:
+        friend class EngineIO;
+        explicit Snapshot(SnapshotBuffer *buffer) : buffer_(buffer) {}
+        void release();
+
+        SnapshotBuffer *buffer_ = nullptr;
+    };
+
+    EngineIO() : slots_(MIN_SLOTS), snapshots_(std::make_unique<SnapshotState>()) {}
     EngineIO(const EngineIO&) = delete;
     EngineIO& operator=(const EngineIO&) = delete;
     EngineIO(EngineIO&&) = default;
     EngineIO& operator=(EngineIO&&) = default;
 
+    template <typename T>
+    void set(const IOKey<T> &key, const std::type_identity_t<T> &value) {
+        static_assert(isInline<T>(), "IOKey values must be trivially copyable and fit inline");
+        setInline(key.hash, key.name, typeId<T>(), &value, sizeof(T));
+    }
+
+    template <typename T>
+    std::optional<T> get(const IOKey<T> &key) const {
+        T value;
+        if (!tryGet(key, value)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    template <typename T>
+    bool tryGet(const IOKey<T> &key, T &out) const {
+        static_assert(isInline<T>(), "IOKey values must be trivially copyable and fit inline");
+        const Slot *slot = findSlot(key.hash);
+        if (!slot || slot->type != typeId<T>()) {
+            return false;
+        }
+        std::memcpy(&out, slot->storage, sizeof(T));
+        return true;
+    }
+
+    // String-keyed slow path: hashes the key at runtime. Small trivially
+    // copyable values share the flat table with IOKey access; anything else
+    // is stored in a std::any map.
     template <typename T>
     void set(const std::string &key, T &&value) {
-        storage_[key] = std::forward<T>(value);
+        using V = std::decay_t<T>;
+        if constexpr (isInline<V>()) {
+            V copy = value;
+            setInline(ioKeyHash(key), nullptr, typeId<V>(), &copy, sizeof(V));
+        } else {
+            bool changed = false;
+            uint64_t hash = 0;
+            if (!watchCounts_.empty()) {
+                hash = ioKeyHash(key);
+                if (watchCounts_.contains(hash)) {
+                    changed = true;
+                    if constexpr (std::equality_comparable<V>) {
+                        auto it = storage_.find(key);
+                        const V *current = it != storage_.end() ? std::any_cast<V>(&it->second) : nullptr;
+                        changed = !current || !(*current == value);
+                    }
+                }
+            }
+            storage_[key] = std::forward<T>(value);
+            if (changed) {
+                pending_.push_back(hash);
+            }
+        }
     }
 
     template <typename T>
     std::optional<T> get(const std::string &key) const {
+        if constexpr (isInline<T>()) {
+            const Slot *slot = findSlot(ioKeyHash(key));
+            if (slot) {
+                if (slot->type != typeId<T>()) {
+                    return std::nullopt;
+                }
+                T value;
+                std::memcpy(&value, slot->storage, sizeof(T));
+                return value;
+            }
+        }
         auto it = storage_.find(key);
         if (it == storage_.end()) {
             return std::nullopt;
         }
-        try {
-            return std::any_cast<T>(it->second);
-        } catch (const std::bad_any_cast &) {
-            return std::nullopt;
+        if (const T *value = std::any_cast<T>(&it->second)) {
+            return *value;
         }
+        return std::nullopt;
     }
 
-    bool has(const std::string &key) const { return storage_.contains(key); }
+    bool has(const std::string &key) const { return findSlot(ioKeyHash(key)) || storage_.contains(key); }
 
-    void erase(const std::string &key) { storage_.erase(key); }
+    void erase(const std::string &key) {
+        uint64_t hash = ioKeyHash(key);
+        eraseSlot(hash);
+        if (storage_.erase(key) && watchCounts_.contains(hash)) {
+            pending_.push_back(hash);
+        }
+    }
+
+    // Change notifications. A value counts as changed when a set() stores
+    // different bytes (or an unequal value for std::any entries), or when it
+    // is erased. Changes are coalesced per key and delivered by
+    // dispatchChanges(), which the engine calls once per frame; callbacks run
+    // on that thread and see the latest value. Keys nobody watches pay no
+    // comparison cost.
+    template <typename T>
+    SubscriptionId subscribe(const IOKey<T> &key, std::type_identity_t<std::function<void(const T &)>> callback) {
+        static_assert(isInline<T>(), "IOKey values must be trivially copyable and fit inline");
+        return addSubscription(key.hash, [callback = std::move(callback), hash = key.hash](const EngineIO &io) {
+            T value;
+            if (readSlot(io.slots_, hash, typeId<T>(), &value, sizeof(T))) {
+                callback(value);
+            }
+        });
+    }
+
+    SubscriptionId subscribe(const std::string &key, std::function<void()> callback) {
+        return addSubscription(ioKeyHash(key), [callback = std::move(callback)](const EngineIO &) { callback(); });
+    }
+
+    // Dirty-flag subscriptions: poll consumeChanged() instead of taking a
+    // callback. The flag starts set so the first poll always rebuilds.
+    template <typename T>
+    SubscriptionId watch(const IOKey<T> &key) {
+        return addSubscription(key.hash, nullptr);
+    }
+
+    SubscriptionId watch(const std::string &key) { return addSubscription(ioKeyHash(key), nullptr); }
+
+    bool consumeChanged(SubscriptionId id) {
+        for (auto &subscription : subscriptions_) {
+            if (subscription->id == id) {
+                return std::exchange(subscription->changed, false);
+            }
+        }
+        return false;
+    }
+
+    void unsubscribe(SubscriptionId id) {
+        for (auto &subscription : subscriptions_) {
+            if (subscription->id != id) {
+                continue;
+            }
+            auto count = watchCounts_.find(subscription->hash);
+            if (count != watchCounts_.end() && --count->second == 0) {
+                watchCounts_.erase(count);
+                setWatched(subscription->hash, false);
+            }
+            // Removed after the current dispatch so a callback can drop itself.
+            subscription->id = 0;
+            hasRemoved_ = true;
+            break;
+        }
+        if (!dispatching_) {
+            removeUnsubscribed();
+        }
+    }
+
+    void dispatchChanges() {
+        if (pending_.empty() || dispatching_) {
+            return;
+        }
+        dispatching_ = true;
+        std::swap(pending_, delivering_);
+        std::sort(delivering_.begin(), delivering_.end());
+        delivering_.erase(std::unique(delivering_.begin(), delivering_.end()), delivering_.end());
+        for (uint64_t hash : delivering_) {
+            if (Slot *slot = const_cast<Slot *>(findSlot(hash))) {
+                slot->pending = false;
+            }
+        }
+        // Indexing, not iterators: callbacks may subscribe. Values they set
+        // are delivered next dispatch.
+        for (uint64_t hash : delivering_) {
+            for (size_t i = 0; i < subscriptions_.size(); ++i) {
+                Subscription &subscription = *subscriptions_[i];
+                if (subscription.id == 0 || subscription.hash != hash) {
+                    continue;
+                }
+                subscription.changed = true;
+                if (subscription.callback) {
+                    subscription.callback(*this);
+                }
+            }
+        }
+        delivering_.clear();
+        dispatching_ = false;
+        removeUnsubscribed();
+    }
+
+    // Copies the typed values into a free snapshot buffer and makes it the
+    // one new readers see. Only values stored in the flat table (IOKey or
+    // small trivially copyable string-keyed values) are included. Returns
+    // false if every spare buffer is still pinned by a reader; the previous
+    // snapshot then stays current.
+    bool publish() {
+        SnapshotState &state = *snapshots_;
+        int current = state.current.load(std::memory_order_relaxed);
+        for (int i = 0; i < SNAPSHOT_BUFFERS; ++i) {
+            if (i == current) {
+                continue;
+            }
+            SnapshotBuffer &buffer = state.buffers[i];
+            if (buffer.readers.load() != 0) {
+                continue;
+            }
+            // Odd sequence claims the buffer; a reader that pinned it in the
+            // meantime is seen here, one that pins later sees the change.
+            buffer.sequence.fetch_add(1);
+            if (buffer.readers.load() != 0) {
+                buffer.sequence.fetch_add(1);
+                continue;
+            }
+            buffer.slots.assign(slots_.begin(), slots_.end());
+            buffer.frame = ++state.published;
+            buffer.sequence.fetch_add(1, std::memory_order_release);
+            state.current.store(i, std::memory_order_release);
+            return true;
+        }
+        return false;
+    }
+
+    // Safe from any thread while the owner keeps writing and publishing.
+    Snapshot snapshot() const {
+        SnapshotState &state = *snapshots_;
+        while (true) {
+            int index = state.current.load(std::memory_order_acquire);
+            if (index < 0) {
+                return Snapshot();
+            }
+            SnapshotBuffer &buffer = state.buffers[index];
+            uint64_t sequence = buffer.sequence.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                continue;
+            }
+            buffer.readers.fetch_add(1);
+            if (buffer.sequence.load() == sequence) {
+                return Snapshot(&buffer);
+            }
+            buffer.readers.fetch_sub(1, std::memory_order_release);
+        }
+    }
 
-    void clear() { storage_.clear(); }
+    // Backs a numeric key with a ring of the last `capacity` values, one per
+    // sampleHistory() call (the engine samples once per frame). Tracking an
+    // already tracked key returns the existing history.
+    template <typename T>
+    IOHistory &track(const IOKey<T> &key, size_t capacity) {
+        static_assert(std::is_arithmetic_v<T>, "only numeric keys can keep a history");
+        for (auto &tracked : tracked_) {
+            if (tracked.hash == key.hash) {
+                return *tracked.history;
+            }
+        }
+        double (*read)(const void *) = [](const void *storage) {
+            T value;
+            std::memcpy(&value, storage, sizeof(T));
+            return (double)value;
+        };
+        tracked_.push_back(Tracked{key.hash, typeId<T>(), read, std::make_unique<IOHistory>(key.name, capacity)});
+        return *tracked_.back().history;
+    }
+
+    template <typename T>
+    const IOHistory *history(const IOKey<T> &key) const { return findHistory(key.hash); }
+    const IOHistory *history(const std::string &key) const { return findHistory(ioKeyHash(key)); }
+
+    std::vector<const IOHistory *> histories() const {
+        std::vector<const IOHistory *> result;
+        for (const auto &tracked : tracked_) {
+            result.push_back(tracked.history.get());
+        }
+        return result;
+    }
+
+    // Appends the current value of every tracked key; keys that are unset or
+    // hold another type are skipped for this sample.
+    void sampleHistory(double time) {
+        for (auto &tracked : tracked_) {
+            const Slot *slot = findSlot(tracked.hash);
+            if (slot && slot->type == tracked.type) {
+                tracked.history->append(time, tracked.read(slot->storage));
+            }
+        }
+    }
+
+    void clear() {
+        slots_.assign(MIN_SLOTS, Slot{});
+        used_ = 0;
+        filled_ = 0;
+        storage_.clear();
+        pending_.clear();
+    }
 
 private:
+    static constexpr size_t MIN_SLOTS = 64;
+    static constexpr int SNAPSHOT_BUFFERS = 4;
+    static constexpr uint64_t EMPTY = 0;
+    static constexpr uint64_t TOMBSTONE = ~0ull;
+
+    using TypeId = const void *;
+
+    struct Slot {
+        uint64_t hash = EMPTY;
+        const char *name = nullptr;
+        TypeId type = nullptr;
+        bool watched = false;
+        bool pending = false;
+        alignas(16) unsigned char storage[INLINE_BYTES];
+    };
+
+    template <typename T>
+    static TypeId typeId() {
+        static const char tag = 0;
+        return &tag;
+    }
+
+    template <typename T>
+    static constexpr bool isInline() {
+        return std::is_trivially_copyable_v<T> && sizeof(T) <= INLINE_BYTES && alignof(T) <= 16;
+    }
+
+    static const Slot *findSlot(const std::vector<Slot> &slots, uint64_t hash) {
+        if (slots.empty()) {
+            return nullptr;
+        }
+        size_t mask = slots.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            const Slot &slot = slots[i];
+            if (slot.hash == hash) {
+                return &slot;
+            }
+            if (slot.hash == EMPTY) {
+                return nullptr;
+            }
+        }
+    }
+
+    const Slot *findSlot(uint64_t hash) const { return findSlot(slots_, hash); }
+
+    static bool readSlot(const std::vector<Slot> &slots, uint64_t hash, TypeId type, void *out, size_t size) {
+        const Slot *slot = findSlot(slots, hash);
+        if (!slot || slot->type != type) {
+            return false;
+        }
+        std::memcpy(out, slot->storage, size);
+        return true;
+    }
+
+    void setInline(uint64_t hash, const char *name, TypeId type, const void *value, size_t size) {
+        Slot *slot = const_cast<Slot *>(findSlot(hash));
+        bool inserted = !slot;
+        if (inserted) {
+            if ((filled_ + 1) * 2 > slots_.size()) {
+                size_t capacity = MIN_SLOTS;
+                while (capacity < (used_ + 1) * 4) {
+                    capacity *= 2;
+                }
+                rehash(capacity);
+            }
+            slot = insertSlot(hash);
+            slot->watched = !watchCounts_.empty() && watchCounts_.contains(hash);
+            slot->pending = false;
+            ++used_;
+        }
+        bool changed = slot->watched &&
+            (inserted || slot->type != type || std::memcmp(slot->storage, value, size) != 0);
+        if (name) {
+            slot->name = name;
+        }
+        slot->type = type;
+        std::memcpy(slot->storage, value, size);
+        if (changed) {
+            markPending(*slot);
+        }
+    }
+
+    void markPending(Slot &slot) {
+        if (!slot.pending) {
+            slot.pending = true;
+            pending_.push_back(slot.hash);
+        }
+    }
+
+    void setWatched(uint64_t hash, bool watched) {
+        if (Slot *slot = const_cast<Slot *>(findSlot(hash))) {
+            slot->watched = watched;
+        }
+    }
+
+    SubscriptionId addSubscription(uint64_t hash, std::function<void(const EngineIO &)> callback) {
+        auto subscription = std::make_unique<Subscription>();
+        subscription->id = nextSubscriptionId_++;
+        subscription->hash = hash;
+        subscription->callback = std::move(callback);
+        subscriptions_.push_back(std::move(subscription));
+        if (watchCounts_[hash]++ == 0) {
+            setWatched(hash, true);
+        }
+        return subscriptions_.back()->id;
+    }
+
+    const IOHistory *findHistory(uint64_t hash) const {
+        for (const auto &tracked : tracked_) {
+            if (tracked.hash == hash) {
+                return tracked.history.get();
+            }
+        }
+        return nullptr;
+    }
+
+    void removeUnsubscribed() {
+        if (!hasRemoved_) {
+            return;
+        }
+        std::erase_if(subscriptions_, [](const auto &subscription) { return subscription->id == 0; });
+        hasRemoved_ = false;
+    }
+
+    Slot *insertSlot(uint64_t hash) {
+        size_t mask = slots_.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            Slot &slot = slots_[i];
+            if (slot.hash == EMPTY) {
+                ++filled_;
+            }
+            if (slot.hash == EMPTY || slot.hash == TOMBSTONE) {
+                slot.hash = hash;
+                return &slot;
+            }
+        }
+    }
+
+    void eraseSlot(uint64_t hash) {
+        Slot *slot = const_cast<Slot *>(findSlot(hash));
+        if (slot) {
+            if (slot->watched && !slot->pending) {
+                pending_.push_back(hash);
+            }
+            slot->hash = TOMBSTONE;
+            slot->type = nullptr;
+            --used_;
+        }
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> old = std::move(slots_);
+        slots_.assign(capacity, Slot{});
+        filled_ = 0;
+        for (const Slot &slot : old) {
+            if (slot.hash != EMPTY && slot.hash != TOMBSTONE) {
+                *insertSlot(slot.hash) = slot;
+            }
+        }
+    }
+
+    struct SnapshotBuffer {
+        std::vector<Slot> slots;
+        uint64_t frame = 0;
+        std::atomic<uint32_t> readers{0};
+        std::atomic<uint64_t> sequence{0};
+    };
+
+    struct SnapshotState {
+        std::array<SnapshotBuffer, SNAPSHOT_BUFFERS> buffers;
+        std::atomic<int> current{-1};
+        uint64_t published = 0;
+    };
+
+    struct Subscription {
+        SubscriptionId id = 0;
+        uint64_t hash = 0;
+        bool changed = true;
+        std::function<void(const EngineIO &)> callback;
+    };
+
+    struct Tracked {
+        uint64_t hash;
+        TypeId type;
+        double (*read)(const void *);
+        std::unique_ptr<IOHistory> history;
+    };
+
+    std::vector<Slot> slots_;
+    std::unique_ptr<SnapshotState> snapshots_;
+    size_t used_ = 0;
+    size_t filled_ = 0;
     std::unordered_map<std::string, std::any> storage_;
+
+    std::vector<std::unique_ptr<Subscription>> subscriptions_;
+    std::unordered_map<uint64_t, uint32_t> watchCounts_;
+    std::vector<uint64_t> pending_;
+    std::vector<uint64_t> delivering_;
+    std::vector<Tracked> tracked_;
+    SubscriptionId nextSubscriptionId_ = 1;
+    bool dispatching_ = false;
+    bool hasRemoved_ = false;
 };
+
+inline uint64_t EngineIO::Snapshot::frame() const {
+    return buffer_ ? buffer_->frame : 0;
+}
+
+inline void EngineIO::Snapshot::release() {
+    if (buffer_) {
+        buffer_->readers.fetch_sub(1, std::memory_order_release);
+        buffer_ = nullptr;
+    }
+}
@@ -0,0 +1,115 @@
+// The packing internals (stbrp_rect) only exist in the implementation, so
+// it has to be on for the first inclusion, which is FontBake.h's.
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "engine/core/FontBake.h"
+#include "engine/core/JobSystem.h"
+#include "engine/core/LogManager.h"
+#include "engine/core/Profiler.h"
+
+#include <algorithm>
+
+namespace {
+    constexpr int MIN_GLYPHS_PER_THREAD = 8;
+
+    bool rasterizeRange(stbtt_pack_context packContext,
+                        const stbtt_fontinfo* info,
+                        stbtt_pack_range range,
+                        stbrp_rect* rects,
+                        int first,
+                        int count)
+    {
+        PROFILE_SCOPE("Font::rasterizeRange");
+        range.first_unicode_codepoint_in_range += first;
+        range.num_chars = count;
+        range.chardata_for_range += first;
+        return stbtt_PackFontRangesRenderIntoRects(&packContext, info, &range, 1, rects + first) != 0;
+    }
+}
+
+bool FontBake::rasterize(const stbtt_fontinfo* info, float fontSize, int firstChar, int numChars,
+                         int initialSize, int maxSize, JobSystem* jobs, Result& result)
+{
+    result.packedChars.assign(numChars, stbtt_packedchar{});
+    stbtt_pack_range range{};
+    range.font_size = fontSize;
+    range.first_unicode_codepoint_in_range = firstChar;
+    range.num_chars = numChars;
+    range.chardata_for_range = result.packedChars.data();
+    
+    std::vector<stbrp_rect> rects(numChars);
+    stbtt_pack_context packContext;
+    int size = initialSize;
+    
+    while (true) {
+        result.pixels.assign((size_t)size * size, 0);
+        if (!stbtt_PackBegin(&packContext, result.pixels.data(), size, size, 0, 1, nullptr)) {
+            LOG_ERROR("Font: Failed to begin packing");
+            return false;
+        }
+        
+        stbtt_PackSetOversampling(&packContext, 2, 2); 
+        
+        int rectCount = stbtt_PackFontRangesGatherRects(&packContext, info, &range, 1, rects.data());
+        stbtt_PackFontRangesPackRects(&packContext, rects.data(), rectCount);
+        
+        bool packed = true;
+        for (const auto& rect : rects) {
+            if (!rect.was_packed) {
+                packed = false;
+                break;
+            }
+        }
+        if (packed) {
+            break;
+        }
+        
+        stbtt_PackEnd(&packContext);
+        if (size >= maxSize) {
+            LOG_ERROR("Font: Failed to pack font range");
+            return false;
+        }
+        size *= 2;
+    }
+    result.size = size;
+    
+    
+    int threadCount = jobs ? (int)jobs->workerCount() + 1 : 1;
+    threadCount = std::min(threadCount, std::max(1, numChars / MIN_GLYPHS_PER_THREAD));
+    int chunkSize = (numChars + threadCount - 1) / threadCount;
+    result.threadCount = threadCount;
+    
+    if (jobs) {
+        jobs->parallelFor(0, numChars, (size_t)chunkSize, [&](size_t first, size_t last) {
+            rasterizeRange(packContext, info, range, rects.data(), (int)first, (int)(last - first));
+        });
+    } else {
+        rasterizeRange(packContext, info, range, rects.data(), 0, numChars);
+    }
+    
+    stbtt_PackEnd(&packContext);
+    
+    
+    int missingGlyph = -1;
+    for (int i = 0; i < numChars; ++i) {
+        if (rects[i].w != 0 && rects[i].h != 0 && stbtt_FindGlyphIndex(info, firstChar + i) == 0) {
+            missingGlyph = i;
+            break;
+        }
+    }
+    
+    result.usedWidth = 0;
+    result.usedHeight = 0;
+    for (int i = 0; i < numChars; ++i) {
+        if (rects[i].w != 0 && rects[i].h != 0) {
+            result.usedWidth = std::max(result.usedWidth, (int)rects[i].x + (int)rects[i].w);
+            result.usedHeight = std::max(result.usedHeight, (int)rects[i].y + (int)rects[i].h);
+            continue;
+        }
+        if (missingGlyph < 0) {
+            LOG_ERROR("Font: Failed to pack font range");
+            return false;
+        }
+        result.packedChars[i] = result.packedChars[missingGlyph];
+    }
+    return true;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "stb_truetype.h"
+
+#include <vector>
+
+class JobSystem;
+
+namespace FontBake {
+    struct Result {
+        // Coverage bitmap, size x size; glyphs occupy usedWidth x usedHeight
+        // from the top-left corner.
+        std::vector<unsigned char> pixels;
+        int size = 0;
+        int usedWidth = 0;
+        int usedHeight = 0;
+        std::vector<stbtt_packedchar> packedChars;
+        int threadCount = 1;
+    };
+
+    // Packs and rasterizes `numChars` codepoints from `firstChar`, growing the
+    // bitmap up to maxSize. Codepoints the face lacks reuse its missing glyph.
+    // With a job system the glyphs are rasterized in parallel; the output is
+    // byte-identical to the serial bake. Needs no GPU, so tools can run it.
+    bool rasterize(const stbtt_fontinfo* info, float fontSize, int firstChar, int numChars,
+                   int initialSize, int maxSize, JobSystem* jobs, Result& result);
+}
@@ -1,18 +1,24 @@
 #include "engine/core/FontManager.h"
+#include "engine/core/FontBake.h"
+#include "engine/core/FontSubset.h"
 #include "engine/core/LogManager.h"
+#include "engine/core/Metrics.h"
+#include "engine/core/Profiler.h"
 #include "engine/utils/Path.h"
 
-#define STB_TRUETYPE_IMPLEMENTATION
 #include "stb_truetype.h"
 
+#include <simd/simd.h>
+
 #include <fstream>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
 
 
-Font::Font(MTL::Device* device, const std::string& fontPath, float fontSize)
-    : device(device), fontPath(fontPath), fontSize(fontSize), valid(false),
-      lineHeight(0), ascent(0), descent(0), fontInfo(nullptr), texture(nullptr)
+Font::Font(GlyphAtlas* atlas, const std::string& fontPath, float fontSize, FontLoadMode mode)
+    : atlas(atlas), fontPath(fontPath), fontSize(fontSize), mode(mode), valid(false),
+      lineHeight(0), ascent(0), descent(0), fontInfo(nullptr)
 {
     LOG_INFO("Font: Loading font from %s at size %.1f", fontPath.c_str(), fontSize);
     
@@ -33,6 +39,21 @@ Font::Font(MTL::Device* device, const std::string& fontPath, float fontSize)
     }
     file.close();
     
+    if (mode == FontLoadMode::Subset) {
+        std::vector<int> codepoints;
+        codepoints.reserve(NUM_CHARS);
+        for (int i = 0; i < NUM_CHARS; ++i) {
+            codepoints.push_back(FIRST_CHAR + i);
+        }
+        
+        std::vector<unsigned char> subset;
+        if (FontSubset::build(fontBuffer, codepoints, subset)) {
+            fontBuffer.swap(subset);
+        } else {
+            LOG_ERROR("Font: Subsetting failed, keeping full face: %s", fontPath.c_str());
+        }
+    }
+    
     
     fontInfo = new stbtt_fontinfo();
     if (!stbtt_InitFont(fontInfo, fontBuffer.data(), 0)) {
@@ -55,12 +76,14 @@ Font::Font(MTL::Device* device, const std::string& fontPath, float fontSize)
     LOG_INFO("Font metrics - ascent: %.2f, descent: %.2f, lineHeight: %.2f", ascent, descent, lineHeight);
     
     
-    bakeFont();
+    valid = bakeFont();
     
-    valid = (texture != nullptr);
+    if (valid && mode == FontLoadMode::Static) {
+        releaseFaceData();
+    }
     
     if (valid) {
-        LOG_INFO("Font: Successfully loaded %s", fontPath.c_str());
+        LOG_INFO("Font: Successfully loaded %s (%zu bytes resident)", fontPath.c_str(), residentBytes());
     }
 }
 
@@ -68,11 +91,25 @@ Font::~Font()
 {
     LOG_DESTROY("Font");
     cleanup();
-    
+    releaseFaceData();
+}
+
+void Font::releaseFaceData()
+{
     if (fontInfo) {
         delete fontInfo;
         fontInfo = nullptr;
     }
+    std::vector<unsigned char>().swap(fontBuffer);
+}
+
+size_t Font::residentBytes() const
+{
+    size_t bytes = fontBuffer.capacity();
+    if (fontInfo) {
+        bytes += sizeof(stbtt_fontinfo);
+    }
+    return bytes + bakedGlyphs.capacity() * sizeof(BakedGlyph);
 }
 
 void Font::cleanup()
@@ -82,45 +119,60 @@ void Font::cleanup()
     }
     cleanedUp = true;
     
-    if (texture) {
-        texture->release();
-        texture = nullptr;
+    if (atlas && hasAtlasBlock) {
+        atlas->release(atlasBlock);
+        hasAtlasBlock = false;
     }
+    valid = false;
+    atlas = nullptr;
 }
 
-void Font::bakeFont()
+bool Font::bakeFont()
 {
+    PROFILE_SCOPE("Font::bakeFont");
+    if (!atlas) {
+        LOG_ERROR("Font: No glyph atlas to bake into");
+        return false;
+    }
     
-    atlasData.resize(ATLAS_WIDTH * ATLAS_HEIGHT);
     bakedGlyphs.resize(NUM_CHARS);
     
+    auto bakeStart = std::chrono::high_resolution_clock::now();
     
-    stbtt_pack_context packContext;
-    if (!stbtt_PackBegin(&packContext, atlasData.data(), ATLAS_WIDTH, ATLAS_HEIGHT, 0, 1, nullptr)) {
-        LOG_ERROR("Font: Failed to begin packing");
-        return;
+    FontBake::Result baked;
+    if (!FontBake::rasterize(fontInfo, fontSize, FIRST_CHAR, NUM_CHARS, INITIAL_SCRATCH_SIZE,
+                             GlyphAtlas::PAGE_SIZE, FontManager::getInstance().getJobSystem(), baked)) {
+        return false;
     }
+    const int usedWidth = baked.usedWidth;
+    const int usedHeight = baked.usedHeight;
     
-    stbtt_PackSetOversampling(&packContext, 2, 2); 
     
-    std::vector<stbtt_packedchar> packedChars(NUM_CHARS);
-    if (!stbtt_PackFontRange(&packContext, fontBuffer.data(), 0, fontSize, FIRST_CHAR, NUM_CHARS, packedChars.data())) {
-        LOG_ERROR("Font: Failed to pack font range");
-        stbtt_PackEnd(&packContext);
-        return;
+    GlyphAtlas::Block block;
+    if (!atlas->allocate(usedWidth, usedHeight, block)) {
+        LOG_ERROR("Font: Failed to allocate %dx%d atlas block", usedWidth, usedHeight);
+        return false;
     }
+    atlas->upload(block, baked.pixels.data(), baked.size);
+    atlasBlock = block;
+    hasAtlasBlock = true;
     
-    stbtt_PackEnd(&packContext);
+    auto bakeEnd = std::chrono::high_resolution_clock::now();
+    double bakeMs = std::chrono::duration<double, std::milli>(bakeEnd - bakeStart).count();
+    METRIC_COUNT("font.bakes", 1);
+    METRIC_COUNT("font.glyphs_baked", NUM_CHARS);
+    METRIC_HISTOGRAM("font.bake_ms", bakeMs);
     
     
+    const float pageScale = 1.0f / (float)GlyphAtlas::PAGE_SIZE;
     for (int i = 0; i < NUM_CHARS; ++i) {
-        const auto& pc = packedChars[i];
+        const auto& pc = baked.packedChars[i];
         auto& bg = bakedGlyphs[i];
         
-        bg.x0 = pc.x0 / (float)ATLAS_WIDTH;
-        bg.y0 = pc.y0 / (float)ATLAS_HEIGHT;
-        bg.x1 = pc.x1 / (float)ATLAS_WIDTH;
-        bg.y1 = pc.y1 / (float)ATLAS_HEIGHT;
+        bg.x0 = (block.x + pc.x0) * pageScale;
+        bg.y0 = (block.y + pc.y0) * pageScale;
+        bg.x1 = (block.x + pc.x1) * pageScale;
+        bg.y1 = (block.y + pc.y1) * pageScale;
         bg.xoff = pc.xoff;
         bg.yoff = pc.yoff;
         bg.xoff2 = pc.xoff2;
@@ -128,31 +180,14 @@ void Font::bakeFont()
         bg.xadvance = pc.xadvance;
         bg.width = (int)(pc.x1 - pc.x0);
         bg.height = (int)(pc.y1 - pc.y0);
+        bg.page = block.page;
+        
+        advances[FIRST_CHAR + i] = pc.xadvance;
     }
     
-    
-    MTL::TextureDescriptor* texDesc = MTL::TextureDescriptor::texture2DDescriptor(
-        MTL::PixelFormatR8Unorm,
-        ATLAS_WIDTH,
-        ATLAS_HEIGHT,
-        false
-    );
-    texDesc->setUsage(MTL::TextureUsageShaderRead);
-    texDesc->setStorageMode(MTL::StorageModeShared);
-    
-    texture = device->newTexture(texDesc);
-    texDesc->release();
-    
-    if (!texture) {
-        LOG_ERROR("Font: Failed to create texture");
-        return;
-    }
-    
-    
-    MTL::Region region = MTL::Region(0, 0, ATLAS_WIDTH, ATLAS_HEIGHT);
-    texture->replaceRegion(region, 0, atlasData.data(), ATLAS_WIDTH);
-    
-    LOG_INFO("Font: Baked %d glyphs into %dx%d atlas", NUM_CHARS, ATLAS_WIDTH, ATLAS_HEIGHT);
+    LOG_INFO("Font: Baked %d glyphs into %dx%d block on atlas page %d in %.2f ms (%d threads)",
+             NUM_CHARS, usedWidth, usedHeight, block.page, bakeMs, baked.threadCount);
+    return true;
 }
 
 const BakedGlyph* Font::getGlyph(char c) const
@@ -166,15 +201,28 @@ const BakedGlyph* Font::getGlyph(char c) const
 
 void Font::measureText(const std::string& text, float& width, float& height) const
 {
-    width = 0.0f;
+    width = measureAdvance(text.data(), text.size());
     height = lineHeight;
+}
+
+float Font::measureAdvance(const char* text, size_t length) const
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text);
+    const float* table = advances.data();
+    
+    simd::float8 acc{};
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        const unsigned char* p = bytes + i;
+        acc += simd::float8{table[p[0]], table[p[1]], table[p[2]], table[p[3]],
+                            table[p[4]], table[p[5]], table[p[6]], table[p[7]]};
+    }
     
-    for (char c : text) {
-        const BakedGlyph* glyph = getGlyph(c);
-        if (glyph) {
-            width += glyph->xadvance;
-        }
+    float width = simd::reduce_add(acc);
+    for (; i < length; ++i) {
+        width += table[bytes[i]];
     }
+    return width;
 }
 
 
@@ -184,9 +232,11 @@ FontManager& FontManager::getInstance()
     return instance;
 }
 
-void FontManager::initialize(MTL::Device* device)
+void FontManager::initialize(MTL::Device* device, JobSystem* jobs, int atlasPages)
 {
     this->device = device;
+    this->jobs = jobs;
+    atlas = std::make_unique<GlyphAtlas>(device, atlasPages);
     LOG_INFO("FontManager: Initialized");
 }
 
@@ -199,7 +249,15 @@ void FontManager::shutdown()
         }
     }
     fontCache.clear();
+    atlas.reset();
     device = nullptr;
+    jobs = nullptr;
+}
+
+FontLoadMode FontManager::getLoadMode(const std::string& fontPath) const
+{
+    auto it = pathLoadModes.find(fontPath);
+    return it != pathLoadModes.end() ? it->second : loadMode;
 }
 
 std::string FontManager::makeFontKey(const std::string& fontPath, float fontSize) const
@@ -214,7 +272,12 @@ std::shared_ptr<Font> FontManager::loadFont(const std::string& fontPath, float f
         return nullptr;
     }
     
-    auto font = std::make_shared<Font>(device, fontPath, fontSize);
+    const FontLoadMode mode = getLoadMode(fontPath);
+    auto font = std::make_shared<Font>(atlas.get(), fontPath, fontSize, mode);
+    if (!font->isValid() && releaseUnused() > 0) {
+        LOG_INFO("FontManager: Retrying %s after freeing unused fonts", fontPath.c_str());
+        font = std::make_shared<Font>(atlas.get(), fontPath, fontSize, mode);
+    }
     if (!font->isValid()) {
         LOG_ERROR("FontManager: Failed to load font: %s", fontPath.c_str());
         return nullptr;
@@ -237,3 +300,25 @@ std::shared_ptr<Font> FontManager::getFont(const std::string& fontPath, float fo
     
     return loadFont(fontPath, fontSize);
 }
+
+void FontManager::unloadFont(const std::string& fontPath, float fontSize)
+{
+    fontCache.erase(makeFontKey(fontPath, fontSize));
+}
+
+size_t FontManager::releaseUnused()
+{
+    size_t released = 0;
+    for (auto it = fontCache.begin(); it != fontCache.end();) {
+        if (it->second.use_count() == 1) {
+            it = fontCache.erase(it);
+            ++released;
+        } else {
+            ++it;
+        }
+    }
+    if (released > 0) {
+        LOG_INFO("FontManager: Released %zu unused fonts", released);
+    }
+    return released;
+}
@@ -1,15 +1,26 @@
 #pragma once
 
 #include <Metal/Metal.hpp>
+#include <array>
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <map>
 #include <memory>
+#include "engine/core/GlyphAtlas.h"
 #include "engine/core/LogManager.h"
 
+class JobSystem;
+
 
 struct stbtt_fontinfo;
 
+enum class FontLoadMode {
+    Full,
+    Subset,
+    Static
+};
+
 struct GlyphMetrics {
     float advanceX;
     float leftBearing;
@@ -22,11 +33,13 @@ struct BakedGlyph {
     float xoff2, yoff2;        
     float xadvance;            
     int width, height;         
+    int page;
 };
 
 class Font {
 public:
-    Font(MTL::Device* device, const std::string& fontPath, float fontSize);
+    Font(GlyphAtlas* atlas, const std::string& fontPath, float fontSize,
+         FontLoadMode mode = FontLoadMode::Full);
     ~Font();
     
     bool isValid() const { return valid; }
@@ -35,23 +48,31 @@ public:
     const BakedGlyph* getGlyph(char c) const;
     
     
-    MTL::Texture* getTexture() const { return texture; }
+    MTL::Texture* getTexture() const { return atlas ? atlas->getTexture() : nullptr; }
     
     float getFontSize() const { return fontSize; }
     float getLineHeight() const { return lineHeight; }
     float getAscent() const { return ascent; }
     float getDescent() const { return descent; }
     
+    FontLoadMode getLoadMode() const { return mode; }
+    size_t residentBytes() const;
+    
     void cleanup();
     
     void measureText(const std::string& text, float& width, float& height) const;
+    float measureAdvance(const char* text, size_t length) const;
 
 private:
-    void bakeFont();
+    bool bakeFont();
+    void releaseFaceData();
     
-    MTL::Device* device;
+    GlyphAtlas* atlas;
+    GlyphAtlas::Block atlasBlock;
+    bool hasAtlasBlock = false;
     std::string fontPath;
     float fontSize;
+    FontLoadMode mode;
     bool valid;
     bool cleanedUp = false;
     
@@ -65,22 +86,25 @@ private:
     stbtt_fontinfo* fontInfo;
     
     
-    static constexpr int ATLAS_WIDTH = 512;
-    static constexpr int ATLAS_HEIGHT = 512;
+    static constexpr int INITIAL_SCRATCH_SIZE = 512;
     static constexpr int FIRST_CHAR = 32;  
     static constexpr int NUM_CHARS = 96;    
     
     std::vector<BakedGlyph> bakedGlyphs;
-    std::vector<unsigned char> atlasData;
-    MTL::Texture* texture;
+    std::array<float, 256> advances{};
 };
 
+// Main thread only: the cache, atlas allocation and uploads are unlocked.
+// Fonts it hands out are read-only once loaded and safe to use from any
+// thread.
 class FontManager {
 public:
     static FontManager& getInstance();
     
     
-    void initialize(MTL::Device* device);
+    // Glyph rasterization fans out over jobs when a job system is given.
+    void initialize(MTL::Device* device, JobSystem* jobs = nullptr,
+                    int atlasPages = GlyphAtlas::DEFAULT_MAX_PAGES);
     
     void shutdown();
     
@@ -88,6 +112,22 @@ public:
     
     
     std::shared_ptr<Font> getFont(const std::string& fontPath, float fontSize);
+    
+    // Drops the cached font; its atlas space is freed once no one else
+    // holds it.
+    void unloadFont(const std::string& fontPath, float fontSize);
+    // Unloads every cached font nothing else references. loadFont does
+    // this by itself when the atlas is full. Returns the number unloaded.
+    size_t releaseUnused();
+    
+    GlyphAtlas* getAtlas() const { return atlas.get(); }
+    JobSystem* getJobSystem() const { return jobs; }
+    
+    void setLoadMode(FontLoadMode mode) { loadMode = mode; }
+    FontLoadMode getLoadMode() const { return loadMode; }
+    // Mode for one font file, overriding the default for fonts loaded after.
+    void setLoadMode(const std::string& fontPath, FontLoadMode mode) { pathLoadModes[fontPath] = mode; }
+    FontLoadMode getLoadMode(const std::string& fontPath) const;
 
 private:
     FontManager() = default;
@@ -96,6 +136,10 @@ private:
     FontManager& operator=(const FontManager&) = delete;
     
     MTL::Device* device = nullptr;
+    JobSystem* jobs = nullptr;
+    std::unique_ptr<GlyphAtlas> atlas;
+    FontLoadMode loadMode = FontLoadMode::Full;
+    std::map<std::string, FontLoadMode> pathLoadModes;
     std::map<std::string, std::shared_ptr<Font>> fontCache;
     
     std::string makeFontKey(const std::string& fontPath, float fontSize) const;
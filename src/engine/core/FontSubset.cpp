@@ -0,0 +1,387 @@
+#include "engine/core/FontSubset.h"
+#include "engine/core/LogManager.h"
+
+#include "stb_truetype.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+
+namespace {
+    constexpr uint16_t ARG_1_AND_2_ARE_WORDS = 0x0001;
+    constexpr uint16_t WE_HAVE_A_SCALE = 0x0008;
+    constexpr uint16_t MORE_COMPONENTS = 0x0020;
+    constexpr uint16_t WE_HAVE_AN_X_AND_Y_SCALE = 0x0040;
+    constexpr uint16_t WE_HAVE_A_TWO_BY_TWO = 0x0080;
+
+    struct TableRef {
+        const unsigned char* data = nullptr;
+        uint32_t length = 0;
+    };
+
+    uint16_t readU16(const unsigned char* p)
+    {
+        return (uint16_t)((p[0] << 8) | p[1]);
+    }
+
+    uint32_t readU32(const unsigned char* p)
+    {
+        return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+    }
+
+    void writeU16(unsigned char* p, uint16_t v)
+    {
+        p[0] = (unsigned char)(v >> 8);
+        p[1] = (unsigned char)(v & 0xFF);
+    }
+
+    void writeU32(unsigned char* p, uint32_t v)
+    {
+        p[0] = (unsigned char)(v >> 24);
+        p[1] = (unsigned char)((v >> 16) & 0xFF);
+        p[2] = (unsigned char)((v >> 8) & 0xFF);
+        p[3] = (unsigned char)(v & 0xFF);
+    }
+
+    void appendU16(std::vector<unsigned char>& out, uint16_t v)
+    {
+        out.push_back((unsigned char)(v >> 8));
+        out.push_back((unsigned char)(v & 0xFF));
+    }
+
+    void appendU32(std::vector<unsigned char>& out, uint32_t v)
+    {
+        appendU16(out, (uint16_t)(v >> 16));
+        appendU16(out, (uint16_t)(v & 0xFFFF));
+    }
+
+    uint32_t tableChecksum(const unsigned char* data, size_t length)
+    {
+        uint32_t sum = 0;
+        for (size_t i = 0; i < length; i += 4) {
+            unsigned char word[4] = {0, 0, 0, 0};
+            std::memcpy(word, data + i, std::min<size_t>(4, length - i));
+            sum += readU32(word);
+        }
+        return sum;
+    }
+
+    bool findTables(const std::vector<unsigned char>& font, std::map<std::string, TableRef>& tables)
+    {
+        if (font.size() < 12) {
+            return false;
+        }
+
+        uint16_t numTables = readU16(font.data() + 4);
+        if (font.size() < 12 + (size_t)numTables * 16) {
+            return false;
+        }
+
+        for (uint16_t i = 0; i < numTables; ++i) {
+            const unsigned char* record = font.data() + 12 + i * 16;
+            uint32_t offset = readU32(record + 8);
+            uint32_t length = readU32(record + 12);
+            if ((size_t)offset + length > font.size()) {
+                return false;
+            }
+            tables[std::string((const char*)record, 4)] = {font.data() + offset, length};
+        }
+        return true;
+    }
+
+    class GlyphSource {
+    public:
+        GlyphSource(const TableRef& glyf, const TableRef& loca, bool longLoca, int numGlyphs)
+            : glyf(glyf), loca(loca), longLoca(longLoca), numGlyphs(numGlyphs) {}
+
+        bool range(int glyph, uint32_t& start, uint32_t& end) const
+        {
+            if (glyph < 0 || glyph >= numGlyphs) {
+                return false;
+            }
+            if (longLoca) {
+                if (loca.length < (uint32_t)(glyph + 2) * 4) return false;
+                start = readU32(loca.data + glyph * 4);
+                end = readU32(loca.data + glyph * 4 + 4);
+            } else {
+                if (loca.length < (uint32_t)(glyph + 2) * 2) return false;
+                start = readU16(loca.data + glyph * 2) * 2u;
+                end = readU16(loca.data + glyph * 2 + 2) * 2u;
+            }
+            return start <= end && end <= glyf.length;
+        }
+
+        const unsigned char* data(uint32_t offset) const { return glyf.data + offset; }
+
+    private:
+        TableRef glyf;
+        TableRef loca;
+        bool longLoca;
+        int numGlyphs;
+    };
+
+    size_t componentArgsSize(uint16_t flags)
+    {
+        size_t size = (flags & ARG_1_AND_2_ARE_WORDS) ? 4 : 2;
+        if (flags & WE_HAVE_A_SCALE) {
+            size += 2;
+        } else if (flags & WE_HAVE_AN_X_AND_Y_SCALE) {
+            size += 4;
+        } else if (flags & WE_HAVE_A_TWO_BY_TWO) {
+            size += 8;
+        }
+        return size;
+    }
+
+    void collectComponents(const GlyphSource& source, int glyph, std::vector<bool>& used)
+    {
+        uint32_t start, end;
+        if (!source.range(glyph, start, end) || end - start < 10) {
+            return;
+        }
+
+        const unsigned char* p = source.data(start);
+        if ((int16_t)readU16(p) >= 0) {
+            return;
+        }
+
+        size_t offset = 10;
+        while (offset + 4 <= end - start) {
+            uint16_t flags = readU16(p + offset);
+            int component = readU16(p + offset + 2);
+            if (component < (int)used.size() && !used[component]) {
+                used[component] = true;
+                collectComponents(source, component, used);
+            }
+            offset += 4 + componentArgsSize(flags);
+            if (!(flags & MORE_COMPONENTS)) {
+                break;
+            }
+        }
+    }
+
+    void remapComponents(unsigned char* p, size_t length, const std::vector<int>& remap)
+    {
+        size_t offset = 10;
+        while (offset + 4 <= length) {
+            uint16_t flags = readU16(p + offset);
+            int component = readU16(p + offset + 2);
+            if (component < (int)remap.size() && remap[component] >= 0) {
+                writeU16(p + offset + 2, (uint16_t)remap[component]);
+            }
+            offset += 4 + componentArgsSize(flags);
+            if (!(flags & MORE_COMPONENTS)) {
+                break;
+            }
+        }
+    }
+
+    std::vector<unsigned char> buildCmap(const std::vector<std::pair<int, int>>& mapping)
+    {
+        uint16_t segCount = (uint16_t)(mapping.size() + 1);
+        uint16_t entrySelector = 0;
+        while ((2u << entrySelector) <= segCount) {
+            ++entrySelector;
+        }
+        uint16_t searchRange = (uint16_t)(2u << entrySelector);
+        uint16_t rangeShift = (uint16_t)(segCount * 2 - searchRange);
+
+        std::vector<unsigned char> out;
+        appendU16(out, 0);
+        appendU16(out, 1);
+        appendU16(out, 3);
+        appendU16(out, 1);
+        appendU32(out, 12);
+
+        appendU16(out, 4);
+        appendU16(out, (uint16_t)(16 + segCount * 8));
+        appendU16(out, 0);
+        appendU16(out, (uint16_t)(segCount * 2));
+        appendU16(out, searchRange);
+        appendU16(out, entrySelector);
+        appendU16(out, rangeShift);
+
+        for (const auto& entry : mapping) appendU16(out, (uint16_t)entry.first);
+        appendU16(out, 0xFFFF);
+        appendU16(out, 0);
+        for (const auto& entry : mapping) appendU16(out, (uint16_t)entry.first);
+        appendU16(out, 0xFFFF);
+        for (const auto& entry : mapping) appendU16(out, (uint16_t)(entry.second - entry.first));
+        appendU16(out, 1);
+        for (size_t i = 0; i < segCount; ++i) appendU16(out, 0);
+
+        return out;
+    }
+}
+
+bool FontSubset::build(const std::vector<unsigned char>& font,
+                       const std::vector<int>& codepoints,
+                       std::vector<unsigned char>& subset)
+{
+    std::map<std::string, TableRef> tables;
+    if (!findTables(font, tables)) {
+        LOG_ERROR("FontSubset: Malformed table directory");
+        return false;
+    }
+
+    for (const char* tag : {"head", "hhea", "maxp", "hmtx", "loca", "glyf", "cmap"}) {
+        if (!tables.count(tag)) {
+            LOG_ERROR("FontSubset: Missing '%s' table", tag);
+            return false;
+        }
+    }
+
+    const TableRef& head = tables["head"];
+    const TableRef& hhea = tables["hhea"];
+    const TableRef& maxp = tables["maxp"];
+    const TableRef& hmtx = tables["hmtx"];
+    if (head.length < 54 || hhea.length < 36 || maxp.length < 6) {
+        LOG_ERROR("FontSubset: Truncated header tables");
+        return false;
+    }
+
+    stbtt_fontinfo info;
+    if (!stbtt_InitFont(&info, font.data(), 0)) {
+        LOG_ERROR("FontSubset: Failed to initialize source face");
+        return false;
+    }
+
+    int numGlyphs = readU16(maxp.data + 4);
+    int numHMetrics = readU16(hhea.data + 34);
+    bool longLoca = readU16(head.data + 50) != 0;
+    if (numHMetrics == 0 || numHMetrics > numGlyphs ||
+        hmtx.length < (uint32_t)numHMetrics * 4 + (uint32_t)(numGlyphs - numHMetrics) * 2) {
+        LOG_ERROR("FontSubset: Truncated hmtx table");
+        return false;
+    }
+    GlyphSource source(tables["glyf"], tables["loca"], longLoca, numGlyphs);
+
+    std::vector<bool> used(numGlyphs, false);
+    used[0] = true;
+    std::vector<std::pair<int, int>> mapping;
+    for (int codepoint : codepoints) {
+        if (codepoint <= 0 || codepoint >= 0xFFFF) {
+            continue;
+        }
+        int glyph = stbtt_FindGlyphIndex(&info, codepoint);
+        if (glyph > 0 && glyph < numGlyphs) {
+            used[glyph] = true;
+            mapping.push_back({codepoint, glyph});
+        }
+    }
+    for (int glyph = 0; glyph < numGlyphs; ++glyph) {
+        if (used[glyph]) {
+            collectComponents(source, glyph, used);
+        }
+    }
+
+    std::vector<int> remap(numGlyphs, -1);
+    std::vector<int> kept;
+    for (int glyph = 0; glyph < numGlyphs; ++glyph) {
+        if (used[glyph]) {
+            remap[glyph] = (int)kept.size();
+            kept.push_back(glyph);
+        }
+    }
+
+    std::sort(mapping.begin(), mapping.end());
+    mapping.erase(std::unique(mapping.begin(), mapping.end(),
+                              [](const auto& a, const auto& b) { return a.first == b.first; }),
+                  mapping.end());
+    for (auto& entry : mapping) {
+        entry.second = remap[entry.second];
+    }
+
+    std::vector<unsigned char> glyf;
+    std::vector<unsigned char> loca;
+    std::vector<unsigned char> hmtxOut;
+    for (int glyph : kept) {
+        appendU32(loca, (uint32_t)glyf.size());
+
+        uint32_t start, end;
+        if (source.range(glyph, start, end) && end > start) {
+            size_t offset = glyf.size();
+            glyf.insert(glyf.end(), source.data(start), source.data(end));
+            if (end - start >= 10 && (int16_t)readU16(source.data(start)) < 0) {
+                remapComponents(glyf.data() + offset, end - start, remap);
+            }
+            while (glyf.size() % 4) {
+                glyf.push_back(0);
+            }
+        }
+
+        int metric = std::min(glyph, numHMetrics - 1);
+        appendU16(hmtxOut, readU16(hmtx.data + metric * 4));
+        if (glyph < numHMetrics) {
+            appendU16(hmtxOut, readU16(hmtx.data + glyph * 4 + 2));
+        } else {
+            appendU16(hmtxOut, readU16(hmtx.data + numHMetrics * 4 + (glyph - numHMetrics) * 2));
+        }
+    }
+    appendU32(loca, (uint32_t)glyf.size());
+
+    std::vector<unsigned char> headOut(head.data, head.data + head.length);
+    writeU32(headOut.data() + 8, 0);
+    writeU16(headOut.data() + 50, 1);
+
+    std::vector<unsigned char> hheaOut(hhea.data, hhea.data + hhea.length);
+    writeU16(hheaOut.data() + 34, (uint16_t)kept.size());
+
+    std::vector<unsigned char> maxpOut(maxp.data, maxp.data + maxp.length);
+    writeU16(maxpOut.data() + 4, (uint16_t)kept.size());
+
+    std::vector<std::pair<std::string, std::vector<unsigned char>>> outTables = {
+        {"cmap", buildCmap(mapping)},
+        {"glyf", std::move(glyf)},
+        {"head", std::move(headOut)},
+        {"hhea", std::move(hheaOut)},
+        {"hmtx", std::move(hmtxOut)},
+        {"loca", std::move(loca)},
+        {"maxp", std::move(maxpOut)},
+    };
+
+    uint16_t numTables = (uint16_t)outTables.size();
+    uint16_t entrySelector = 0;
+    while ((2u << entrySelector) <= numTables) {
+        ++entrySelector;
+    }
+    uint16_t searchRange = (uint16_t)(16u << entrySelector);
+
+    subset.clear();
+    appendU32(subset, 0x00010000);
+    appendU16(subset, numTables);
+    appendU16(subset, searchRange);
+    appendU16(subset, entrySelector);
+    appendU16(subset, (uint16_t)(numTables * 16 - searchRange));
+
+    size_t directory = subset.size();
+    subset.resize(directory + numTables * 16);
+
+    size_t headOffset = 0;
+    for (size_t i = 0; i < outTables.size(); ++i) {
+        const auto& table = outTables[i];
+        size_t offset = subset.size();
+        subset.insert(subset.end(), table.second.begin(), table.second.end());
+        while (subset.size() % 4) {
+            subset.push_back(0);
+        }
+
+        unsigned char* record = subset.data() + directory + i * 16;
+        std::memcpy(record, table.first.data(), 4);
+        writeU32(record + 4, tableChecksum(subset.data() + offset, table.second.size()));
+        writeU32(record + 8, (uint32_t)offset);
+        writeU32(record + 12, (uint32_t)table.second.size());
+
+        if (table.first == "head") {
+            headOffset = offset;
+        }
+    }
+
+    writeU32(subset.data() + headOffset + 8, 0xB1B0AFBAu - tableChecksum(subset.data(), subset.size()));
+
+    LOG_INFO("FontSubset: Kept %zu of %d glyphs, %zu -> %zu bytes",
+             kept.size(), numGlyphs, font.size(), subset.size());
+    return true;
+}
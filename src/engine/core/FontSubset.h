@@ -0,0 +1,13 @@
+#pragma once
+
+#include <vector>
+
+namespace FontSubset {
+    // Builds a compact TrueType face containing only the glyphs reachable from
+    // `codepoints` (plus .notdef and composite components). Glyph ids are
+    // renumbered; the face keeps head/hhea/maxp/hmtx/loca/glyf and a fresh
+    // format 4 cmap. Returns false for faces without glyf outlines.
+    bool build(const std::vector<unsigned char>& font,
+               const std::vector<int>& codepoints,
+               std::vector<unsigned char>& subset);
+}
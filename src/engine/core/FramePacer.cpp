@@ -0,0 +1,137 @@
+#include "engine/core/FramePacer.h"
+#include "engine/core/Metrics.h"
+#include "engine/core/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    constexpr double UNCAPPED_BUDGET_SECONDS = 1.0 / 60.0;
+    constexpr int64_t MIN_SPIN_MARGIN_NS = 100000;
+    constexpr int64_t MAX_SPIN_MARGIN_NS = 4000000;
+    constexpr size_t PRESENT_HISTORY = 120;
+}
+
+struct FramePacer::PresentLog
+{
+    std::mutex mutex;
+    double lastPresent = 0.0;
+    double intervals[PRESENT_HISTORY] = {};
+    size_t count = 0;
+    size_t next = 0;
+
+    void record(double presented)
+    {
+        if (presented <= 0.0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (lastPresent > 0.0 && presented > lastPresent) {
+            double interval = presented - lastPresent;
+            intervals[next] = interval;
+            next = (next + 1) % PRESENT_HISTORY;
+            count = std::min(count + 1, PRESENT_HISTORY);
+            METRIC_HISTOGRAM("frame.present_interval_ms", interval * 1000.0);
+        }
+        lastPresent = presented;
+    }
+};
+
+FramePacer::FramePacer(double targetSeconds)
+    : presents_(std::make_shared<PresentLog>())
+{
+    setTarget(targetSeconds);
+}
+
+void FramePacer::setTarget(double seconds)
+{
+    targetSeconds_ = seconds > 0.0 ? seconds : 0.0;
+    deadlineNs_ = 0;
+}
+
+double FramePacer::budget() const
+{
+    return targetSeconds_ > 0.0 ? targetSeconds_ : UNCAPPED_BUDGET_SECONDS;
+}
+
+void FramePacer::beginFrame()
+{
+    frameStartNs_ = Profiler::nowNs();
+}
+
+void FramePacer::endFrame(double blockedSeconds)
+{
+    int64_t now = Profiler::nowNs();
+    lastWorkSeconds_ = std::max((double)(now - frameStartNs_) * 1e-9 - blockedSeconds, 0.0);
+    double ratio = lastWorkSeconds_ / budget();
+    pressure_ = pressure_ == 0.0 ? ratio : pressure_ * 0.9 + ratio * 0.1;
+    if (ratio > 1.0) {
+        ++overrunStreak_;
+        METRIC_COUNT("frame.budget_overruns", 1);
+    } else {
+        overrunStreak_ = 0;
+    }
+    METRIC_GAUGE("frame.pressure", pressure_);
+
+    if (targetSeconds_ <= 0.0) {
+        return;
+    }
+
+    PROFILE_SCOPE("FramePacing");
+    const int64_t targetNs = (int64_t)(targetSeconds_ * 1e9);
+    if (deadlineNs_ == 0) {
+        deadlineNs_ = frameStartNs_;
+    }
+    deadlineNs_ += targetNs;
+    if (now >= deadlineNs_) {
+        // Late: start a fresh schedule rather than rushing to catch up.
+        deadlineNs_ = now;
+        return;
+    }
+
+    if (deadlineNs_ - now > spinMarginNs_) {
+        const int64_t wakeNs = deadlineNs_ - spinMarginNs_;
+        std::this_thread::sleep_for(std::chrono::nanoseconds(wakeNs - now));
+        const int64_t lateNs = Profiler::nowNs() - wakeNs;
+        // Grow straight to what we saw, shrink slowly.
+        const int64_t wanted = lateNs + lateNs / 4;
+        spinMarginNs_ = wanted > spinMarginNs_ ? wanted : (spinMarginNs_ * 15 + wanted) / 16;
+        spinMarginNs_ = std::clamp(spinMarginNs_, MIN_SPIN_MARGIN_NS, MAX_SPIN_MARGIN_NS);
+    }
+    while (Profiler::nowNs() < deadlineNs_) {
+        std::this_thread::yield();
+    }
+    METRIC_HISTOGRAM("frame.pacing_error_ms", (double)(Profiler::nowNs() - deadlineNs_) / 1e6);
+}
+
+std::function<void(double)> FramePacer::presentRecorder() const
+{
+    return [log = presents_](double presentedSeconds) { log->record(presentedSeconds); };
+}
+
+FramePacer::PresentStats FramePacer::presentStats() const
+{
+    PresentStats stats;
+    std::lock_guard<std::mutex> lock(presents_->mutex);
+    stats.samples = presents_->count;
+    if (stats.samples == 0) {
+        return stats;
+    }
+    double sum = 0.0;
+    for (size_t i = 0; i < stats.samples; ++i) {
+        sum += presents_->intervals[i];
+        stats.maxSeconds = std::max(stats.maxSeconds, presents_->intervals[i]);
+    }
+    stats.meanSeconds = sum / (double)stats.samples;
+    double variance = 0.0;
+    for (size_t i = 0; i < stats.samples; ++i) {
+        double d = presents_->intervals[i] - stats.meanSeconds;
+        variance += d * d;
+    }
+    stats.jitterSeconds = std::sqrt(variance / (double)stats.samples);
+    return stats;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// Caps the frame rate at a target frame time and reports how the frame is
+// doing against its budget. endFrame() sleeps for most of what is left of
+// the frame and spins the rest; the spin margin follows how late the OS
+// actually wakes us. Deadlines advance by whole target periods so small
+// errors don't accumulate.
+//
+// The budget is the target frame time, or 1/60 s when uncapped. pressure()
+// is the smoothed ratio of frame work to budget; above 1 the frame is
+// overrunning and subsystems should shed optional work.
+class FramePacer {
+public:
+    struct PresentStats {
+        size_t samples = 0;
+        double meanSeconds = 0.0;
+        double jitterSeconds = 0.0;   // standard deviation of the intervals
+        double maxSeconds = 0.0;
+    };
+
+    explicit FramePacer(double targetSeconds = 0.0);
+
+    // 0 leaves the frame rate uncapped.
+    void setTarget(double seconds);
+    double target() const { return targetSeconds_; }
+    double budget() const;
+
+    void beginFrame();
+    // Waits out the rest of the frame when a target is set. blockedSeconds
+    // is time the frame spent waiting on the display or render thread; it
+    // doesn't count as work.
+    void endFrame(double blockedSeconds = 0.0);
+
+    // Records display present times (seconds) from any thread; stays valid
+    // after the pacer is destroyed, so it can outlive in-flight frames.
+    std::function<void(double)> presentRecorder() const;
+    PresentStats presentStats() const;
+
+    double lastWorkSeconds() const { return lastWorkSeconds_; }
+    double pressure() const { return pressure_; }
+    bool overBudget() const { return lastWorkSeconds_ > budget(); }
+    uint32_t overrunStreak() const { return overrunStreak_; }
+
+private:
+    struct PresentLog;
+
+    double targetSeconds_ = 0.0;
+    int64_t frameStartNs_ = 0;
+    int64_t deadlineNs_ = 0;
+    int64_t spinMarginNs_ = 1000000;
+    double lastWorkSeconds_ = 0.0;
+    double pressure_ = 0.0;
+    uint32_t overrunStreak_ = 0;
+    std::shared_ptr<PresentLog> presents_;
+};
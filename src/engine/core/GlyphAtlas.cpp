@@ -0,0 +1,206 @@
+#include "engine/core/GlyphAtlas.h"
+#include "engine/core/LogManager.h"
+
+#include <algorithm>
+
+GlyphAtlas::GlyphAtlas(MTL::Device* device, int maxPages)
+    : maxPages(std::max(1, maxPages))
+{
+    LOG_CONSTRUCT("GlyphAtlas");
+    
+    MTL::TextureDescriptor* texDesc = MTL::TextureDescriptor::alloc()->init();
+    texDesc->setTextureType(MTL::TextureType2DArray);
+    texDesc->setPixelFormat(MTL::PixelFormatR8Unorm);
+    texDesc->setWidth(PAGE_SIZE);
+    texDesc->setHeight(PAGE_SIZE);
+    texDesc->setArrayLength(this->maxPages);
+    texDesc->setUsage(MTL::TextureUsageShaderRead);
+    texDesc->setStorageMode(MTL::StorageModeShared);
+    
+    texture = device->newTexture(texDesc);
+    texDesc->release();
+    
+    if (!texture) {
+        LOG_ERROR("GlyphAtlas: Failed to create %dx%dx%d texture array", PAGE_SIZE, PAGE_SIZE, this->maxPages);
+    }
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    LOG_DESTROY("GlyphAtlas");
+    if (texture) {
+        texture->release();
+        texture = nullptr;
+    }
+}
+
+bool GlyphAtlas::allocate(int width, int height, Block& block)
+{
+    if (!texture || width <= 0 || height <= 0) {
+        return false;
+    }
+    
+    int paddedWidth = width + GUTTER;
+    int paddedHeight = height + GUTTER;
+    if (paddedWidth > PAGE_SIZE || paddedHeight > PAGE_SIZE) {
+        LOG_ERROR("GlyphAtlas: Block %dx%d exceeds page size %d", width, height, PAGE_SIZE);
+        return false;
+    }
+    
+    for (size_t i = 0; i < pages.size(); ++i) {
+        if (allocateOnPage(pages[i], paddedWidth, paddedHeight, block.x, block.y)) {
+            block.page = (int)i;
+            block.width = width;
+            block.height = height;
+            ++liveBlocks;
+            return true;
+        }
+    }
+    
+    if (!openPage()) {
+        LOG_ERROR("GlyphAtlas: All %d pages are full (%d live blocks), cannot place a %dx%d block; "
+                  "unload fonts or raise EngineConfig::glyphAtlasPages", maxPages, liveBlocks, width, height);
+        return false;
+    }
+    
+    allocateOnPage(pages.back(), paddedWidth, paddedHeight, block.x, block.y);
+    block.page = (int)pages.size() - 1;
+    block.width = width;
+    block.height = height;
+    ++liveBlocks;
+    return true;
+}
+
+void GlyphAtlas::release(const Block& block)
+{
+    if (block.page < 0 || block.page >= (int)pages.size()) {
+        return;
+    }
+    
+    Page& page = pages[block.page];
+    auto shelf = std::find_if(page.shelves.begin(), page.shelves.end(),
+                              [&](const Shelf& s) { return s.y == block.y; });
+    if (shelf == page.shelves.end() || shelf->liveBlocks <= 0) {
+        LOG_ERROR("GlyphAtlas: Release of unknown block at page %d (%d, %d)", block.page, block.x, block.y);
+        return;
+    }
+    
+    const int paddedWidth = block.width + GUTTER;
+    clearRegion(block.page, block.x, block.y, paddedWidth, shelf->height);
+    --liveBlocks;
+    
+    if (--shelf->liveBlocks == 0) {
+        shelf->cursorX = 0;
+        shelf->freeSpans.clear();
+    } else if (block.x + paddedWidth == shelf->cursorX) {
+        shelf->cursorX = block.x;
+    } else {
+        shelf->freeSpans.push_back({block.x, paddedWidth});
+    }
+    
+    // Pull the cursor back over released spans that now end at it.
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < shelf->freeSpans.size(); ++i) {
+            if (shelf->freeSpans[i].x + shelf->freeSpans[i].width == shelf->cursorX) {
+                shelf->cursorX = shelf->freeSpans[i].x;
+                shelf->freeSpans.erase(shelf->freeSpans.begin() + i);
+                merged = true;
+                break;
+            }
+        }
+    }
+    
+    // Empty shelves at the top of the page give their rows back.
+    while (!page.shelves.empty() && page.shelves.back().liveBlocks == 0) {
+        page.nextY = page.shelves.back().y;
+        page.shelves.pop_back();
+    }
+}
+
+void GlyphAtlas::upload(const Block& block, const unsigned char* pixels, int bytesPerRow)
+{
+    if (!texture) {
+        return;
+    }
+    
+    MTL::Region region = MTL::Region(block.x, block.y, block.width, block.height);
+    texture->replaceRegion(region, 0, block.page, pixels, bytesPerRow, 0);
+}
+
+bool GlyphAtlas::allocateOnPage(Page& page, int width, int height, int& x, int& y)
+{
+    Shelf* best = nullptr;
+    Span* bestSpan = nullptr;
+    for (auto& shelf : page.shelves) {
+        if (shelf.height < height) {
+            continue;
+        }
+        Span* span = nullptr;
+        for (auto& candidate : shelf.freeSpans) {
+            if (candidate.width >= width && (!span || candidate.width < span->width)) {
+                span = &candidate;
+            }
+        }
+        if (!span && shelf.cursorX + width > PAGE_SIZE) {
+            continue;
+        }
+        if (!best || shelf.height < best->height) {
+            best = &shelf;
+            bestSpan = span;
+        }
+    }
+    
+    if (best && bestSpan) {
+        x = bestSpan->x;
+        y = best->y;
+        bestSpan->x += width;
+        bestSpan->width -= width;
+        if (bestSpan->width == 0) {
+            best->freeSpans.erase(best->freeSpans.begin() + (bestSpan - best->freeSpans.data()));
+        }
+        ++best->liveBlocks;
+        return true;
+    }
+    
+    if (!best) {
+        if (page.nextY + height > PAGE_SIZE) {
+            return false;
+        }
+        page.shelves.push_back({page.nextY, height, 0});
+        page.nextY += height;
+        best = &page.shelves.back();
+    }
+    
+    x = best->cursorX;
+    y = best->y;
+    best->cursorX += width;
+    ++best->liveBlocks;
+    return true;
+}
+
+bool GlyphAtlas::openPage()
+{
+    if ((int)pages.size() >= maxPages) {
+        return false;
+    }
+    
+    clearRegion((int)pages.size(), 0, 0, PAGE_SIZE, PAGE_SIZE);
+    
+    pages.emplace_back();
+    LOG_INFO("GlyphAtlas: Opened page %d", (int)pages.size() - 1);
+    return true;
+}
+
+void GlyphAtlas::clearRegion(int page, int x, int y, int width, int height)
+{
+    if (!texture) {
+        return;
+    }
+    width = std::min(width, PAGE_SIZE - x);
+    height = std::min(height, PAGE_SIZE - y);
+    std::vector<unsigned char> zeros((size_t)width * height, 0);
+    MTL::Region region = MTL::Region(x, y, width, height);
+    texture->replaceRegion(region, 0, page, zeros.data(), width, 0);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Metal/Metal.hpp>
+#include <vector>
+
+class GlyphAtlas {
+public:
+    static constexpr int PAGE_SIZE = 1024;
+    static constexpr int DEFAULT_MAX_PAGES = 8;
+    
+    struct Block {
+        int page = 0;
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+    };
+    
+    // maxPages fixes the texture array length; it can't grow later.
+    explicit GlyphAtlas(MTL::Device* device, int maxPages = DEFAULT_MAX_PAGES);
+    ~GlyphAtlas();
+    
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+    
+    bool allocate(int width, int height, Block& block);
+    void upload(const Block& block, const unsigned char* pixels, int bytesPerRow);
+    // Returns a block's space to its shelf and clears its pixels. A shelf
+    // whose blocks are all released is reused from scratch.
+    void release(const Block& block);
+    
+    MTL::Texture* getTexture() const { return texture; }
+    int getPageCount() const { return (int)pages.size(); }
+    int getMaxPages() const { return maxPages; }
+    int getLiveBlocks() const { return liveBlocks; }
+
+private:
+    struct Span {
+        int x;
+        int width;
+    };
+    
+    struct Shelf {
+        int y;
+        int height;
+        int cursorX;
+        int liveBlocks = 0;
+        // Released spans left of cursorX.
+        std::vector<Span> freeSpans;
+    };
+    
+    struct Page {
+        std::vector<Shelf> shelves;
+        int nextY = 0;
+    };
+    
+    static constexpr int GUTTER = 1;
+    
+    bool allocateOnPage(Page& page, int width, int height, int& x, int& y);
+    bool openPage();
+    void clearRegion(int page, int x, int y, int width, int height);
+    
+    MTL::Texture* texture = nullptr;
+    int maxPages;
+    int liveBlocks = 0;
+    std::vector<Page> pages;
+};
@@ -0,0 +1,108 @@
+#include "engine/core/IOHistory.h"
+#include "engine/core/LogManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+
+IOHistory::IOHistory(std::string name, size_t capacity)
+    : name(std::move(name)), samples(std::max<size_t>(capacity, 1))
+{
+}
+
+size_t IOHistory::windowStart(double seconds) const
+{
+    if (count == 0 || seconds <= 0.0) {
+        return 0;
+    }
+    double cutoff = latest().time - seconds;
+    size_t index = count;
+    while (index > 0 && at(index - 1).time >= cutoff) {
+        --index;
+    }
+    return index;
+}
+
+IOHistory::Stats IOHistory::stats(double seconds) const
+{
+    Stats result;
+    size_t start = windowStart(seconds);
+    if (start >= count) {
+        return result;
+    }
+    result.min = result.max = at(start).value;
+    double sum = 0.0;
+    for (size_t i = start; i < count; ++i) {
+        double value = at(i).value;
+        result.min = std::min(result.min, value);
+        result.max = std::max(result.max, value);
+        sum += value;
+    }
+    result.count = count - start;
+    result.mean = sum / (double)result.count;
+    return result;
+}
+
+double IOHistory::percentile(double seconds, double p) const
+{
+    size_t start = windowStart(seconds);
+    if (start >= count) {
+        return 0.0;
+    }
+    scratch.clear();
+    for (size_t i = start; i < count; ++i) {
+        scratch.push_back(at(i).value);
+    }
+    double rank = std::ceil(std::clamp(p, 0.0, 1.0) * (double)scratch.size());
+    size_t nth = rank > 0.0 ? (size_t)rank - 1 : 0;
+    std::nth_element(scratch.begin(), scratch.begin() + (long)nth, scratch.end());
+    return scratch[nth];
+}
+
+bool writeHistoryCsv(const char *path, const std::vector<const IOHistory *> &histories)
+{
+    FILE *file = std::fopen(path, "w");
+    if (!file) {
+        LOG_ERROR("IOHistory: failed to open %s", path);
+        return false;
+    }
+    std::fputs("key,time,value\n", file);
+    for (const IOHistory *history : histories) {
+        for (size_t i = 0; i < history->size(); ++i) {
+            const IOHistory::Sample &sample = history->at(i);
+            std::fprintf(file, "%s,%.6f,%.9g\n", history->getName().c_str(), sample.time, sample.value);
+        }
+    }
+    std::fclose(file);
+    return true;
+}
+
+bool writeHistoryBinary(const char *path, const std::vector<const IOHistory *> &histories)
+{
+    FILE *file = std::fopen(path, "wb");
+    if (!file) {
+        LOG_ERROR("IOHistory: failed to open %s", path);
+        return false;
+    }
+    std::fwrite("MTLHIST1", 1, 8, file);
+    uint32_t seriesCount = (uint32_t)histories.size();
+    std::fwrite(&seriesCount, sizeof(seriesCount), 1, file);
+    for (const IOHistory *history : histories) {
+        uint32_t nameBytes = (uint32_t)history->getName().size();
+        uint32_t samples = (uint32_t)history->size();
+        std::fwrite(&nameBytes, sizeof(nameBytes), 1, file);
+        std::fwrite(history->getName().data(), 1, nameBytes, file);
+        std::fwrite(&samples, sizeof(samples), 1, file);
+        for (size_t i = 0; i < history->size(); ++i) {
+            std::fwrite(&history->at(i), sizeof(IOHistory::Sample), 1, file);
+        }
+    }
+    bool ok = std::ferror(file) == 0;
+    std::fclose(file);
+    if (!ok) {
+        LOG_ERROR("IOHistory: failed writing %s", path);
+    }
+    return ok;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Fixed-capacity ring of (time, value) samples for one EngineIO key. Append
+// is O(1) and overwrites the oldest sample; window queries cover samples no
+// older than `seconds` before the newest one (seconds <= 0 means all).
+// Not thread-safe: sample and query on the thread that owns the EngineIO.
+class IOHistory
+{
+public:
+    struct Sample
+    {
+        double time;
+        double value;
+    };
+
+    struct Stats
+    {
+        size_t count = 0;
+        double min = 0.0;
+        double max = 0.0;
+        double mean = 0.0;
+    };
+
+    IOHistory(std::string name, size_t capacity);
+
+    void append(double time, double value)
+    {
+        samples[head] = Sample{time, value};
+        head = head + 1 == samples.size() ? 0 : head + 1;
+        if (count < samples.size()) {
+            ++count;
+        }
+    }
+
+    const std::string &getName() const { return name; }
+    size_t size() const { return count; }
+    size_t capacity() const { return samples.size(); }
+    void clear() { head = count = 0; }
+
+    // 0 is the oldest retained sample.
+    const Sample &at(size_t index) const
+    {
+        size_t start = head + samples.size() - count;
+        return samples[(start + index) % samples.size()];
+    }
+    const Sample &latest() const { return at(count - 1); }
+
+    Stats stats(double seconds) const;
+    double percentile(double seconds, double p) const;
+
+private:
+    size_t windowStart(double seconds) const;
+
+    std::string name;
+    std::vector<Sample> samples;
+    size_t head = 0;
+    size_t count = 0;
+    mutable std::vector<double> scratch;
+};
+
+// Offline dumps. CSV has one `key,time,value` row per sample. The binary
+// form is "MTLHIST1", a uint32 series count, then per series a uint32 name
+// length, the name, a uint32 sample count and that many (time, value)
+// double pairs, all in native byte order.
+bool writeHistoryCsv(const char *path, const std::vector<const IOHistory *> &histories);
+bool writeHistoryBinary(const char *path, const std::vector<const IOHistory *> &histories);
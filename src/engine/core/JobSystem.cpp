@@ -0,0 +1,207 @@
+#include "engine/core/JobSystem.h"
+#include "engine/core/LogManager.h"
+#include "engine/core/Profiler.h"
+
+#include <algorithm>
+
+struct JobSystem::Job {
+    Task task;
+    std::atomic<bool> finished{false};
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Job>> continuations;
+};
+
+namespace
+{
+    struct WorkerIdentity
+    {
+        const JobSystem *owner = nullptr;
+        unsigned index = 0;
+    };
+
+    thread_local WorkerIdentity t_worker;
+}
+
+bool JobSystem::Handle::done() const
+{
+    return !job_ || job_->finished.load(std::memory_order_acquire);
+}
+
+JobSystem::JobSystem(unsigned workerCount)
+{
+    if (workerCount == 0) {
+        workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    }
+    for (unsigned i = 0; i <= workerCount; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    threads_.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        threads_.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+    LOG_INFO("JobSystem: started %u workers", workerCount);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+JobSystem::Handle JobSystem::submit(Task task)
+{
+    auto job = std::make_shared<Job>();
+    job->task = std::move(task);
+    enqueue(job);
+    return Handle(std::move(job));
+}
+
+JobSystem::Handle JobSystem::then(const Handle &after, Task task)
+{
+    auto job = std::make_shared<Job>();
+    job->task = std::move(task);
+    if (after.job_) {
+        std::lock_guard<std::mutex> lock(after.job_->mutex);
+        if (!after.job_->finished.load(std::memory_order_relaxed)) {
+            after.job_->continuations.push_back(job);
+            return Handle(std::move(job));
+        }
+    }
+    enqueue(job);
+    return Handle(std::move(job));
+}
+
+void JobSystem::wait(const Handle &handle)
+{
+    while (!handle.done()) {
+        if (!runOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &body)
+{
+    if (begin >= end) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    if (threads_.empty() || end - begin <= grain) {
+        body(begin, end);
+        return;
+    }
+
+    std::atomic<size_t> remaining{(end - begin + grain - 1) / grain - 1};
+    for (size_t first = begin + grain; first < end; first += grain) {
+        size_t last = std::min(first + grain, end);
+        auto job = std::make_shared<Job>();
+        job->task = [&body, &remaining, first, last] {
+            body(first, last);
+            remaining.fetch_sub(1, std::memory_order_release);
+        };
+        enqueue(std::move(job));
+    }
+    body(begin, begin + grain);
+
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (!runOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::enqueue(std::shared_ptr<Job> job)
+{
+    Queue &queue = t_worker.owner == this ? *queues_[t_worker.index] : *queues_.back();
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    // Pairs with the sleeper count in workerLoop: either the worker sees
+    // the new job before sleeping or we see it asleep and wake it.
+    queued_.fetch_add(1);
+    if (sleepers_.load() > 0) {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wake_.notify_one();
+    }
+}
+
+std::shared_ptr<JobSystem::Job> JobSystem::take()
+{
+    size_t count = queues_.size();
+    size_t own = t_worker.owner == this ? t_worker.index : count - 1;
+    {
+        Queue &queue = *queues_[own];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            std::shared_ptr<Job> job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            return job;
+        }
+    }
+    for (size_t offset = 1; offset < count; ++offset) {
+        Queue &queue = *queues_[(own + offset) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            std::shared_ptr<Job> job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+bool JobSystem::runOne()
+{
+    if (queued_.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+    std::shared_ptr<Job> job = take();
+    if (!job) {
+        return false;
+    }
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    execute(job);
+    return true;
+}
+
+void JobSystem::execute(const std::shared_ptr<Job> &job)
+{
+    job->task();
+    job->task = nullptr;
+
+    std::vector<std::shared_ptr<Job>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->finished.store(true, std::memory_order_release);
+        continuations.swap(job->continuations);
+    }
+    for (auto &continuation : continuations) {
+        enqueue(std::move(continuation));
+    }
+}
+
+void JobSystem::workerLoop(unsigned index)
+{
+    t_worker = WorkerIdentity{this, index};
+    PROFILE_THREAD("Job Worker");
+
+    while (true) {
+        if (runOne()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        sleepers_.fetch_add(1);
+        wake_.wait(lock, [this] { return stopping_ || queued_.load() > 0; });
+        sleepers_.fetch_sub(1);
+        if (stopping_) {
+            return;
+        }
+    }
+}
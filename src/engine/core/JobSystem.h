@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Each worker owns a deque: it pushes and pops
+// its own jobs at the back and steals from the front of the others. Jobs
+// submitted from non-worker threads go to a shared queue every worker
+// steals from. Threads that wait (wait(), parallelFor) run queued jobs
+// instead of blocking, so waiting from the main thread adds a core.
+class JobSystem {
+    struct Job;
+
+public:
+    using Task = std::function<void()>;
+
+    class Handle {
+    public:
+        Handle() = default;
+
+        bool done() const;
+        explicit operator bool() const { return job_ != nullptr; }
+
+    private:
+        friend class JobSystem;
+        explicit Handle(std::shared_ptr<Job> job) : job_(std::move(job)) {}
+
+        std::shared_ptr<Job> job_;
+    };
+
+    // workerCount 0 uses one worker per hardware thread beyond the caller.
+    explicit JobSystem(unsigned workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned workerCount() const { return (unsigned)threads_.size(); }
+
+    Handle submit(Task task);
+    // Queues task once `after` has finished (immediately if it already has).
+    Handle then(const Handle &after, Task task);
+    void wait(const Handle &handle);
+
+    // Calls body(chunkBegin, chunkEnd) over [begin, end) in chunks of at
+    // most `grain` items, and returns once every chunk has run. The calling
+    // thread runs chunks too.
+    void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &body);
+
+    // Runs one queued job on the calling thread; false if none was found.
+    bool runOne();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<Job>> jobs;
+    };
+
+    void enqueue(std::shared_ptr<Job> job);
+    std::shared_ptr<Job> take();
+    void execute(const std::shared_ptr<Job> &job);
+    void workerLoop(unsigned index);
+
+    // One queue per worker plus the shared queue for outside threads (last).
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> queued_{0};
+    std::atomic<unsigned> sleepers_{0};
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
@@ -0,0 +1,166 @@
+#include "engine/core/LogCapture.h"
+#include "engine/core/LogClock.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace LogManager
+{
+    LogCapture *LogCapture::open(const char *path, size_t capacityBytes, uint32_t generation)
+    {
+        if (capacityBytes < sizeof(CaptureFileHeader) + 4096) {
+            capacityBytes = sizeof(CaptureFileHeader) + 4096;
+        }
+
+        int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            std::fprintf(stderr, "LogCapture: failed to open %s\n", path);
+            return nullptr;
+        }
+        if (::ftruncate(fd, (off_t)capacityBytes) != 0) {
+            std::fprintf(stderr, "LogCapture: failed to size %s to %zu bytes\n", path, capacityBytes);
+            ::close(fd);
+            return nullptr;
+        }
+
+        void *mapping = ::mmap(nullptr, capacityBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            std::fprintf(stderr, "LogCapture: failed to map %s\n", path);
+            ::close(fd);
+            return nullptr;
+        }
+
+        LogCapture *capture = new LogCapture();
+        capture->fd = fd;
+        capture->base = static_cast<unsigned char *>(mapping);
+        capture->capacity = capacityBytes;
+        capture->generation = generation;
+        capture->cursor.store(sizeof(CaptureFileHeader), std::memory_order_relaxed);
+
+        CaptureFileHeader header{};
+        std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+        header.version = CAPTURE_VERSION;
+        header.headerBytes = sizeof(CaptureFileHeader);
+        header.capacityBytes = capacityBytes;
+        header.startTimestampNs = clockBase().wallNs;
+        header.startMonotonicNs = clockBase().monotonicNs;
+        std::memcpy(capture->base, &header, sizeof(header));
+
+        return capture;
+    }
+
+    LogCapture::~LogCapture()
+    {
+        if (!base) {
+            return;
+        }
+
+        uint64_t used = std::min<uint64_t>(cursor.load(std::memory_order_acquire), capacity);
+        CaptureFileHeader *header = reinterpret_cast<CaptureFileHeader *>(base);
+        header->usedBytes = used;
+        header->droppedRecords = dropped.load(std::memory_order_relaxed);
+
+        ::msync(base, capacity, MS_SYNC);
+        ::munmap(base, capacity);
+        if (::ftruncate(fd, (off_t)used) != 0) {
+            std::fprintf(stderr, "LogCapture: failed to trim capture to %llu bytes\n", (unsigned long long)used);
+        }
+        ::close(fd);
+        base = nullptr;
+    }
+
+    unsigned char *LogCapture::reserve(size_t bytes, size_t &size)
+    {
+        size = (bytes + 7) & ~size_t(7);
+        uint64_t offset = cursor.fetch_add(size, std::memory_order_relaxed);
+        if (offset + size + sizeof(CaptureRecordHeader) > capacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return base + offset;
+    }
+
+    void LogCapture::commit(unsigned char *at, uint32_t size, CaptureRecordKind kind)
+    {
+        CaptureRecordHeader *header = reinterpret_cast<CaptureRecordHeader *>(at);
+        header->kind = (uint16_t)kind;
+        header->reserved = 0;
+        __atomic_store_n(&header->size, size, __ATOMIC_RELEASE);
+    }
+
+    bool LogCapture::writeSite(const Site &site)
+    {
+        size_t fileLength = std::strlen(site.file);
+        size_t tagLength = site.tag ? std::strlen(site.tag) : 0;
+        size_t fmtLength = std::strlen(site.fmt);
+
+        size_t size;
+        unsigned char *at = reserve(sizeof(CaptureRecordHeader) + sizeof(CaptureSite) +
+                                    fileLength + tagLength + fmtLength + 3, size);
+        if (!at) {
+            return false;
+        }
+
+        CaptureSite body{};
+        body.id = site.id;
+        body.line = site.line;
+        body.level = (uint8_t)site.level;
+        body.hasTag = site.tag ? 1 : 0;
+        body.fileLength = (uint16_t)fileLength;
+        body.tagLength = (uint16_t)tagLength;
+        body.fmtLength = (uint16_t)fmtLength;
+
+        unsigned char *p = at + sizeof(CaptureRecordHeader);
+        std::memcpy(p, &body, sizeof(body));
+        p += sizeof(body);
+        std::memcpy(p, site.file, fileLength + 1);
+        p += fileLength + 1;
+        if (site.tag) {
+            std::memcpy(p, site.tag, tagLength);
+        }
+        p[tagLength] = '\0';
+        p += tagLength + 1;
+        std::memcpy(p, site.fmt, fmtLength + 1);
+
+        commit(at, (uint32_t)size, CaptureRecordKind::Site);
+        return true;
+    }
+
+    bool LogCapture::write(const LogRecord &record)
+    {
+        Site &site = const_cast<Site &>(*record.site);
+        uint32_t seen = site.captureGeneration.load(std::memory_order_acquire);
+        if (seen != generation &&
+            site.captureGeneration.compare_exchange_strong(seen, generation, std::memory_order_acq_rel)) {
+            writeSite(site);
+        }
+
+        size_t argBytes = record.argCount * sizeof(LogArg);
+        size_t size;
+        unsigned char *at = reserve(sizeof(CaptureRecordHeader) + sizeof(CaptureEvent) +
+                                    argBytes + record.stringBytes, size);
+        if (!at) {
+            return false;
+        }
+
+        CaptureEvent body{};
+        body.id = site.id;
+        body.monotonicNs = record.monotonicNs;
+        body.argCount = record.argCount;
+        body.stringBytes = record.stringBytes;
+
+        unsigned char *p = at + sizeof(CaptureRecordHeader);
+        std::memcpy(p, &body, sizeof(body));
+        p += sizeof(body);
+        std::memcpy(p, record.args, argBytes);
+        p += argBytes;
+        std::memcpy(p, record.strings, record.stringBytes);
+
+        commit(at, (uint32_t)size, CaptureRecordKind::Event);
+        return true;
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "engine/core/LogRecord.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace LogManager
+{
+    // On-disk layout of a binary capture. Records follow the header, are
+    // 8-byte aligned and start with a CaptureRecordHeader; a zero size marks
+    // the end of the written data. Values are stored in native byte order.
+    // Event times are monotonic; startTimestampNs/startMonotonicNs convert
+    // them to wall time.
+    constexpr char CAPTURE_MAGIC[8] = {'M', 'T', 'L', 'B', 'L', 'O', 'G', '1'};
+    constexpr uint32_t CAPTURE_VERSION = 2;
+
+    enum class CaptureRecordKind : uint16_t { Site = 1, Event = 2 };
+
+    struct CaptureFileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerBytes;
+        uint64_t capacityBytes;
+        uint64_t usedBytes;
+        int64_t startTimestampNs;
+        uint64_t droppedRecords;
+        int64_t startMonotonicNs;
+        uint8_t reserved[8];
+    };
+
+    struct CaptureRecordHeader
+    {
+        uint32_t size;
+        uint16_t kind;
+        uint16_t reserved;
+    };
+
+    struct CaptureSite
+    {
+        uint64_t id;
+        uint32_t line;
+        uint8_t level;
+        uint8_t hasTag;
+        uint16_t fileLength;
+        uint16_t tagLength;
+        uint16_t fmtLength;
+        uint32_t reserved;
+    };
+
+    struct CaptureEvent
+    {
+        uint64_t id;
+        int64_t monotonicNs;
+        uint8_t argCount;
+        uint8_t reserved;
+        uint16_t stringBytes;
+        uint32_t reserved2;
+    };
+
+    static_assert(sizeof(CaptureFileHeader) == 64, "capture header layout changed");
+    static_assert(sizeof(CaptureRecordHeader) == 8, "capture record header layout changed");
+    static_assert(sizeof(CaptureSite) == 24, "capture site layout changed");
+    static_assert(sizeof(CaptureEvent) == 24, "capture event layout changed");
+    static_assert(sizeof(LogArg) == 16, "capture argument layout changed");
+
+    class LogCapture
+    {
+    public:
+        static LogCapture *open(const char *path, size_t capacityBytes, uint32_t generation);
+        ~LogCapture();
+
+        LogCapture(const LogCapture &) = delete;
+        LogCapture &operator=(const LogCapture &) = delete;
+
+        bool write(const LogRecord &record);
+        uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    private:
+        LogCapture() = default;
+
+        unsigned char *reserve(size_t bytes, size_t &size);
+        void commit(unsigned char *at, uint32_t size, CaptureRecordKind kind);
+        bool writeSite(const Site &site);
+
+        int fd = -1;
+        unsigned char *base = nullptr;
+        size_t capacity = 0;
+        uint32_t generation = 0;
+        alignas(64) std::atomic<uint64_t> cursor{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+}
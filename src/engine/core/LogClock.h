@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace LogManager
+{
+    // Records are stamped with monotonic nanoseconds and converted to wall
+    // time when formatted, using a base pair taken on first use.
+    inline int64_t monotonicNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    struct ClockBase
+    {
+        int64_t monotonicNs;
+        int64_t wallNs;
+    };
+
+    inline const ClockBase &clockBase()
+    {
+        static const ClockBase base{
+            LogManager::monotonicNs(),
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count()};
+        return base;
+    }
+
+    inline int64_t wallFromMonotonic(int64_t ticks, const ClockBase &base = clockBase())
+    {
+        return base.wallNs + (ticks - base.monotonicNs);
+    }
+
+    // Renders "YYYY-mm-dd HH:MM:SS.mmm". The date/second prefix is only
+    // rebuilt when the second changes; otherwise just the milliseconds are
+    // written. Not thread-safe; keep one per thread.
+    class TimestampFormatter
+    {
+    public:
+        static constexpr size_t LENGTH = 23;
+
+        // out must hold LENGTH + 1 bytes.
+        const char *format(int64_t wallNs, char *out)
+        {
+            int64_t second = wallNs / 1000000000;
+            int64_t millis = (wallNs / 1000000) % 1000;
+            if (wallNs < 0 && millis != 0) {
+                second -= 1;
+                millis += 1000;
+            }
+
+            if (second != cachedSecond) {
+                std::time_t t = (std::time_t)second;
+                std::tm tm{};
+#if defined(_POSIX_VERSION) || defined(__APPLE__)
+                localtime_r(&t, &tm);
+#else
+                std::tm *tmp = std::localtime(&t);
+                if (tmp) tm = *tmp;
+#endif
+                if (std::strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S.", &tm) != LENGTH - 3) {
+                    std::snprintf(prefix, sizeof(prefix), "0000-00-00 00:00:00.");
+                }
+                cachedSecond = second;
+            }
+
+            std::memcpy(out, prefix, LENGTH - 3);
+            out[LENGTH - 3] = (char)('0' + millis / 100);
+            out[LENGTH - 2] = (char)('0' + (millis / 10) % 10);
+            out[LENGTH - 1] = (char)('0' + millis % 10);
+            out[LENGTH] = '\0';
+            return out;
+        }
+
+    private:
+        int64_t cachedSecond = INT64_MIN;
+        char prefix[32] = {};
+    };
+}
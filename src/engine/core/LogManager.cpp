@@ -1,79 +1,274 @@
 #include "engine/core/LogManager.h"
+#include "engine/core/LogCapture.h"
+#include "engine/core/LogClock.h"
+#include "engine/core/LogSink.h"
+#include <algorithm>
 #include <chrono>
-#include <ctime>
-#include <iostream>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace {
-    static std::atomic<bool> g_info_enabled{true};
-    static std::atomic<bool> g_debug_enabled{true};
-    static std::atomic<bool> g_error_enabled{true};
     static std::mutex g_log_mutex;
 
-    const char *kReset = "\033[0m";
-    const char *kRed = "\033[0;31m";
-    const char *kGreen = "\033[0;32m";
-    const char *kYellow = "\033[1;33m";
-    const char *kBlue = "\033[0;34m";
-    const char *kMagenta = "\033[0;35m";
-    const char *kCyan = "\033[0;36m";
+    constexpr size_t QUEUE_CAPACITY = 4096;
+    constexpr size_t BATCH_SIZE = 256;
 
-    bool levelEnabled(LogManager::Level level)
+    // Sinks are only touched by whichever thread holds g_sink_mutex: the
+    // logging thread per batch, or a caller writing synchronously.
+    std::mutex g_sink_mutex;
+    std::vector<std::shared_ptr<LogManager::LogSink>> &sinks()
     {
-        switch (level)
-        {
-        case LogManager::Level::Info:
-            return g_info_enabled.load();
-        case LogManager::Level::Debug:
-            return g_debug_enabled.load();
-        case LogManager::Level::Error:
-            return g_error_enabled.load();
+        static auto *instance = new std::vector<std::shared_ptr<LogManager::LogSink>>{
+            std::make_shared<LogManager::ConsoleSink>()};
+        return *instance;
+    }
+
+    void writeLine(LogManager::Level level, const char *tag, int64_t monotonicNs, const char *message)
+    {
+        thread_local LogManager::TimestampFormatter formatter;
+        char timestr[LogManager::TimestampFormatter::LENGTH + 1];
+        int64_t wallNs = LogManager::wallFromMonotonic(monotonicNs);
+        LogManager::LogLine line{level, tag, wallNs, formatter.format(wallNs, timestr), message};
+        for (const auto &sink : sinks()) {
+            sink->write(line);
         }
-        return false;
     }
 
-    const char *levelPrefix(LogManager::Level level)
+    void writeRecord(const LogManager::LogRecord &record)
     {
-        switch (level)
-        {
-        case LogManager::Level::Info:
-            return kGreen;
-        case LogManager::Level::Debug:
-            return kYellow;
-        case LogManager::Level::Error:
-            return kRed;
+        const LogManager::Site &site = *record.site;
+        char message[1024];
+        LogManager::formatMessage(site.fmt, record.args, record.argCount, record.strings, record.stringBytes,
+                                  message, sizeof(message));
+        writeLine(site.level, site.tag, record.monotonicNs, message);
+    }
+
+    void flushSinks()
+    {
+        for (const auto &sink : sinks()) {
+            sink->flush();
         }
-        return kReset;
     }
 
-    const char *levelName(LogManager::Level level)
+    class RecordQueue
+    {
+    public:
+        RecordQueue() : slots(QUEUE_CAPACITY)
+        {
+            for (size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bool tryPush(const LogManager::LogRecord &record)
+        {
+            size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            Slot *slot;
+            while (true) {
+                slot = &slots[pos & (QUEUE_CAPACITY - 1)];
+                size_t seq = slot->sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            copyRecord(slot->record, record);
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool tryPop(LogManager::LogRecord &record)
+        {
+            size_t pos = dequeuePos.load(std::memory_order_relaxed);
+            Slot *slot;
+            while (true) {
+                slot = &slots[pos & (QUEUE_CAPACITY - 1)];
+                size_t seq = slot->sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+                if (diff == 0) {
+                    if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            copyRecord(record, slot->record);
+            slot->sequence.store(pos + QUEUE_CAPACITY, std::memory_order_release);
+            return true;
+        }
+
+        size_t enqueued() const
+        {
+            return enqueuePos.load(std::memory_order_acquire);
+        }
+
+    private:
+        struct Slot
+        {
+            std::atomic<size_t> sequence;
+            LogManager::LogRecord record;
+        };
+
+        static void copyRecord(LogManager::LogRecord &dst, const LogManager::LogRecord &src)
+        {
+            std::memcpy(&dst, &src, offsetof(LogManager::LogRecord, args) + src.argCount * sizeof(LogManager::LogArg));
+            std::memcpy(dst.strings, src.strings, src.stringBytes);
+        }
+
+        std::vector<Slot> slots;
+        alignas(64) std::atomic<size_t> enqueuePos{0};
+        alignas(64) std::atomic<size_t> dequeuePos{0};
+    };
+
+    class Backend
     {
-        switch (level)
+    public:
+        Backend()
+        {
+            running.store(true, std::memory_order_release);
+            worker = std::thread(&Backend::run, this);
+            std::atexit([] { LogManager::shutdown(); });
+        }
+
+        bool push(const LogManager::LogRecord &record)
+        {
+            if (!running.load(std::memory_order_acquire)) {
+                writeSync(record);
+                return true;
+            }
+            if (!queue.tryPush(record)) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        }
+
+        void flush()
+        {
+            uint64_t target = queue.enqueued();
+            while (running.load(std::memory_order_acquire) &&
+                   processed.load(std::memory_order_acquire) < target) {
+                std::this_thread::yield();
+            }
+        }
+
+        void stop()
+        {
+            std::lock_guard<std::mutex> lock(g_log_mutex);
+            if (!running.exchange(false)) {
+                return;
+            }
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+
+        uint64_t droppedCount() const
+        {
+            return dropped.load(std::memory_order_relaxed);
+        }
+
+    private:
+        void run()
+        {
+            LogManager::LogRecord record;
+            uint64_t reportedDrops = 0;
+
+            while (true) {
+                bool active = running.load(std::memory_order_acquire);
+                size_t count = 0;
+                bool wrote = false;
+                {
+                    std::lock_guard<std::mutex> lock(g_sink_mutex);
+                    while (count < BATCH_SIZE && queue.tryPop(record)) {
+                        writeRecord(record);
+                        ++count;
+                    }
+                    wrote = count > 0;
+
+                    uint64_t drops = dropped.load(std::memory_order_relaxed);
+                    if (drops != reportedDrops) {
+                        char message[96];
+                        std::snprintf(message, sizeof(message), "Log queue full, dropped %llu messages",
+                                      (unsigned long long)(drops - reportedDrops));
+                        writeLine(LogManager::Level::Error, nullptr, LogManager::monotonicNs(), message);
+                        reportedDrops = drops;
+                        wrote = true;
+                    }
+
+                    if (wrote) {
+                        flushSinks();
+                    }
+                }
+
+                // Only popped records count: flush() compares this against
+                // the number enqueued.
+                if (count > 0) {
+                    processed.fetch_add(count, std::memory_order_release);
+                }
+                if (wrote) {
+                    continue;
+                }
+
+                if (!active) {
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        void writeSync(const LogManager::LogRecord &record)
         {
-        case LogManager::Level::Info:
-            return "INFO";
-        case LogManager::Level::Debug:
-            return "DEBUG";
-        case LogManager::Level::Error:
-            return "ERROR";
+            std::lock_guard<std::mutex> lock(g_sink_mutex);
+            writeRecord(record);
+            flushSinks();
         }
-        return "";
+
+        RecordQueue queue;
+        std::thread worker;
+        std::atomic<bool> running{false};
+        std::atomic<uint64_t> processed{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    Backend &backend()
+    {
+        static Backend *instance = new Backend();
+        return *instance;
     }
 
-    const char *tagColor(const char *tag)
+    // Writers bump g_capture_users before loading the pointer so close can
+    // wait for in-flight writes before unmapping.
+    std::atomic<LogManager::LogCapture *> g_capture{nullptr};
+    std::atomic<int> g_capture_users{0};
+    std::atomic<uint32_t> g_capture_generation{0};
+
+    bool writeCapture(const LogManager::LogRecord &record)
     {
-        
-        if (!tag) return kReset;
-        
-        if (std::strcmp(tag, "CONSTRUCT") == 0) return kMagenta;
-        if (std::strcmp(tag, "DESTROY") == 0) return kRed;
-        if (std::strcmp(tag, "START") == 0) return kBlue;
-        if (std::strcmp(tag, "FINISH") == 0) return kGreen;
-        if (std::strcmp(tag, "SHADER") == 0) return kCyan;
-        if (std::strcmp(tag, "STEP") == 0) return kYellow;
-        return kReset;
+        g_capture_users.fetch_add(1);
+        LogManager::LogCapture *capture = g_capture.load();
+        if (capture) {
+            capture->write(record);
+        }
+        g_capture_users.fetch_sub(1, std::memory_order_release);
+        return capture != nullptr;
     }
 }
 
@@ -82,103 +277,114 @@ namespace LogManager
 
     void setEnabled(Level level, bool enabled)
     {
-        switch (level)
-        {
-        case Level::Info:
-            g_info_enabled.store(enabled);
-            break;
-        case Level::Debug:
-            g_debug_enabled.store(enabled);
-            break;
-        case Level::Error:
-            g_error_enabled.store(enabled);
-            break;
+        for (size_t slot = 0; slot < TAG_SLOT_COUNT; ++slot) {
+            setFilterBits(filterBit(level, (TagSlot)slot), enabled);
+        }
+    }
+
+    void setTagEnabled(const char *tag, bool enabled)
+    {
+        for (size_t level = 0; level < LEVEL_COUNT; ++level) {
+            setFilterBits(filterBit((Level)level, tagSlot(tag)), enabled);
+        }
+    }
+
+    void setEnabled(Level level, const char *tag, bool enabled)
+    {
+        setFilterBits(filterBit(level, tagSlot(tag)), enabled);
+    }
+
+    void setFilterBits(uint64_t bits, bool enabled)
+    {
+        if (enabled) {
+            g_filter_mask.fetch_or(bits, std::memory_order_relaxed);
+        } else {
+            g_filter_mask.fetch_and(~bits, std::memory_order_relaxed);
         }
     }
 
     bool isEnabled(Level level)
     {
-        return levelEnabled(level);
+        uint64_t levelBits = 0;
+        for (size_t slot = 0; slot < TAG_SLOT_COUNT; ++slot) {
+            levelBits |= filterBit(level, (TagSlot)slot);
+        }
+        return (g_filter_mask.load(std::memory_order_relaxed) & levelBits) != 0;
     }
 
-    void log(Level level, const char *fmt, ...)
+    void addSink(std::shared_ptr<LogSink> sink)
     {
-        if (!levelEnabled(level))
+        if (!sink) {
             return;
+        }
+        std::lock_guard<std::mutex> lock(g_sink_mutex);
+        sinks().push_back(std::move(sink));
+    }
+
+    void removeSink(const std::shared_ptr<LogSink> &sink)
+    {
+        std::lock_guard<std::mutex> lock(g_sink_mutex);
+        sinks().erase(std::remove(sinks().begin(), sinks().end(), sink), sinks().end());
+    }
+
+    void clearSinks()
+    {
+        std::lock_guard<std::mutex> lock(g_sink_mutex);
+        sinks().clear();
+    }
 
-        
-        va_list args;
-        va_start(args, fmt);
-
-        
-        char buffer[1024];
-        vsnprintf(buffer, sizeof(buffer), fmt, args);
-        va_end(args);
-
-    
-    auto now = std::chrono::system_clock::now();
-    std::time_t t = std::chrono::system_clock::to_time_t(now);
-    
-    long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
-    std::tm tm{};
-#if defined(_POSIX_VERSION) || defined(__APPLE__)
-    localtime_r(&t, &tm);
-#else
-    
-    std::tm *tmp = std::localtime(&t);
-    if (tmp) tm = *tmp;
-#endif
-    char timebuf[80];
-    std::strftime(timebuf, sizeof(timebuf), "%Y-%m-%d %H:%M:%S", &tm);
-    char timestr[96];
-    std::snprintf(timestr, sizeof(timestr), "%s.%03lld", timebuf, ms);
-
-        std::lock_guard<std::mutex> lock(g_log_mutex);
-    const char *prefixColor = levelPrefix(level);
-    const char *name = levelName(level);
-
-    
-    std::cout << prefixColor << "[" << name << "] " << kReset << timestr << " - " << buffer << std::endl;
-    }
-
-    void logTagged(Level level, const char *tag, const char *fmt, ...)
-    {
-        if (!levelEnabled(level))
+    void submit(LogRecord &record)
+    {
+        record.monotonicNs = monotonicNs();
+        if (g_capture.load(std::memory_order_relaxed) && writeCapture(record)) {
             return;
+        }
+        backend().push(record);
+    }
 
-        va_list args;
-        va_start(args, fmt);
-        char buffer[1024];
-        vsnprintf(buffer, sizeof(buffer), fmt, args);
-        va_end(args);
-
-    
-    auto now = std::chrono::system_clock::now();
-    std::time_t t = std::chrono::system_clock::to_time_t(now);
-    long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
-    std::tm tm{};
-#if defined(_POSIX_VERSION) || defined(__APPLE__)
-    localtime_r(&t, &tm);
-#else
-    std::tm *tmp = std::localtime(&t);
-    if (tmp) tm = *tmp;
-#endif
-    char timebuf[80];
-    std::strftime(timebuf, sizeof(timebuf), "%Y-%m-%d %H:%M:%S", &tm);
-    char timestr[96];
-    std::snprintf(timestr, sizeof(timestr), "%s.%03lld", timebuf, ms);
-
-        std::lock_guard<std::mutex> lock(g_log_mutex);
-
-        const char *levelC = levelPrefix(level);
-        const char *name = levelName(level);
-        const char *tcolor = tagColor(tag);
-
-    
-    std::cout << levelC << "[" << name << "] " << kReset
-          << timestr << " "
-                  << tcolor << "[" << (tag ? tag : "") << "] " << kReset
-                  << "- " << buffer << std::endl;
-    }
-
-} 
+    void flush()
+    {
+        backend().flush();
+    }
+
+    void shutdown()
+    {
+        closeBinaryCapture();
+        backend().stop();
+    }
+
+    uint64_t droppedCount()
+    {
+        return backend().droppedCount();
+    }
+
+    bool openBinaryCapture(const char *path, size_t capacityBytes)
+    {
+        closeBinaryCapture();
+
+        uint32_t generation = g_capture_generation.fetch_add(1, std::memory_order_relaxed) + 1;
+        LogCapture *capture = LogCapture::open(path, capacityBytes, generation);
+        if (!capture) {
+            return false;
+        }
+        g_capture.store(capture, std::memory_order_release);
+        return true;
+    }
+
+    void closeBinaryCapture()
+    {
+        LogCapture *capture = g_capture.exchange(nullptr);
+        if (!capture) {
+            return;
+        }
+        while (g_capture_users.load() != 0) {
+            std::this_thread::yield();
+        }
+        if (capture->droppedCount() > 0) {
+            std::fprintf(stderr, "LogCapture: capture full, dropped %llu records\n",
+                         (unsigned long long)capture->droppedCount());
+        }
+        delete capture;
+    }
+
+}
@@ -1,43 +1,89 @@
 #pragma once
 
 #include <atomic>
-#include <cstdarg>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include "engine/config.h"
+#include "engine/core/LogRecord.h"
+#include "engine/core/LogSink.h"
 
 
 
 
 namespace LogManager
 {
-    enum class Level { Info, Debug, Error };
-
     
+    // One bit per (level, tag slot); see filterBit(). Everything starts enabled.
+    inline std::atomic<uint64_t> g_filter_mask{~0ull};
+
     void setEnabled(Level level, bool enabled);
+    void setTagEnabled(const char *tag, bool enabled);
+    void setEnabled(Level level, const char *tag, bool enabled);
+    void setFilterBits(uint64_t bits, bool enabled);
     bool isEnabled(Level level);
 
+    inline bool isEnabled(const Site &site)
+    {
+        return (g_filter_mask.load(std::memory_order_relaxed) & site.filterBit) != 0;
+    }
+
+    // The console sink is installed by default; sinks receive formatted
+    // lines on the logging thread.
+    void addSink(std::shared_ptr<LogSink> sink);
+    void removeSink(const std::shared_ptr<LogSink> &sink);
+    void clearSinks();
+
+    
+    void submit(LogRecord &record);
+    void flush();
+    void shutdown();
+    uint64_t droppedCount();
+
     
-    void log(Level level, const char *fmt, ...);
+    // Each LOG_* expansion owns a static Site holding its level, tag and
+    // format literal; string arguments are copied into the record.
+    template <typename... Args>
+    inline void log(Site &site, Args... args)
+    {
+        if (!isEnabled(site))
+            return;
+
+        LogRecord record;
+        record.site = &site;
+        encodeArgs(record, args...);
+        submit(record);
+    }
+
     
-    void logTagged(Level level, const char *tag, const char *fmt, ...);
+    bool openBinaryCapture(const char *path, size_t capacityBytes);
+    void closeBinaryCapture();
 
 } 
 
 
+#define LOG_SITE_CALL(level, tag, fmt, ...) \
+    do { \
+        static LogManager::Site logSite_(level, tag, fmt, __FILE__, __LINE__); \
+        LogManager::log(logSite_, ##__VA_ARGS__); \
+    } while (0)
+
+
 #ifdef ENABLE_LOG_INFO
-#define LOG_INFO(fmt, ...) LogManager::log(LogManager::Level::Info, fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...) LOG_SITE_CALL(LogManager::Level::Info, nullptr, fmt, ##__VA_ARGS__)
 #else
 #define LOG_INFO(fmt, ...) ((void)0)
 #endif
 
 
 #ifdef ENABLE_LOG_INFO
-#define LOG_TAG_INFO(tag, fmt, ...) LogManager::logTagged(LogManager::Level::Info, tag, fmt, ##__VA_ARGS__)
+#define LOG_TAG_INFO(tag, fmt, ...) LOG_SITE_CALL(LogManager::Level::Info, tag, fmt, ##__VA_ARGS__)
 #define LOG_CONSTRUCT(fmt, ...) LOG_TAG_INFO("CONSTRUCT", fmt, ##__VA_ARGS__)
 #define LOG_DESTROY(fmt, ...) LOG_TAG_INFO("DESTROY", fmt, ##__VA_ARGS__)
 #define LOG_START(fmt, ...) LOG_TAG_INFO("START", fmt, ##__VA_ARGS__)
 #define LOG_FINISH(fmt, ...) LOG_TAG_INFO("FINISH", fmt, ##__VA_ARGS__)
 #define LOG_STEP(fmt, ...) LOG_TAG_INFO("STEP", fmt, ##__VA_ARGS__)
+#define LOG_SHADER(fmt, ...) LOG_TAG_INFO("SHADER", fmt, ##__VA_ARGS__)
 #else
 #define LOG_TAG_INFO(tag, fmt, ...) ((void)0)
 #define LOG_CONSTRUCT(fmt, ...) ((void)0)
@@ -45,16 +91,17 @@ namespace LogManager
 #define LOG_START(fmt, ...) ((void)0)
 #define LOG_FINISH(fmt, ...) ((void)0)
 #define LOG_STEP(fmt, ...) ((void)0)
+#define LOG_SHADER(fmt, ...) ((void)0)
 #endif
 
 #ifdef ENABLE_LOG_DEBUG
-#define LOG_DEBUG(fmt, ...) LogManager::log(LogManager::Level::Debug, fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(fmt, ...) LOG_SITE_CALL(LogManager::Level::Debug, nullptr, fmt, ##__VA_ARGS__)
 #else
 #define LOG_DEBUG(fmt, ...) ((void)0)
 #endif
 
 #ifdef ENABLE_LOG_ERROR
-#define LOG_ERROR(fmt, ...) LogManager::log(LogManager::Level::Error, fmt, ##__VA_ARGS__)
+#define LOG_ERROR(fmt, ...) LOG_SITE_CALL(LogManager::Level::Error, nullptr, fmt, ##__VA_ARGS__)
 #else
 #define LOG_ERROR(fmt, ...) ((void)0)
 #endif
@@ -0,0 +1,249 @@
+#include "engine/core/LogRecord.h"
+
+#include <cstdio>
+
+namespace
+{
+    struct OutputBuffer
+    {
+        char *out;
+        size_t size;
+        size_t length = 0;
+
+        void append(const char *text, size_t count)
+        {
+            if (length + 1 >= size) {
+                return;
+            }
+            size_t room = size - 1 - length;
+            if (count > room) {
+                count = room;
+            }
+            std::memcpy(out + length, text, count);
+            length += count;
+            out[length] = '\0';
+        }
+
+        template <typename T>
+        void appendFormatted(const char *spec, T value)
+        {
+            if (length + 1 >= size) {
+                return;
+            }
+            int written = std::snprintf(out + length, size - length, spec, value);
+            if (written > 0) {
+                length += (size_t)written;
+                if (length >= size) {
+                    length = size - 1;
+                }
+            }
+        }
+
+        template <typename T>
+        void appendFormatted(const char *spec, int width, T value)
+        {
+            if (length + 1 >= size) {
+                return;
+            }
+            int written = std::snprintf(out + length, size - length, spec, width, value);
+            if (written > 0) {
+                length += (size_t)written;
+                if (length >= size) {
+                    length = size - 1;
+                }
+            }
+        }
+    };
+
+    bool isFlag(char c)
+    {
+        return c == '-' || c == '+' || c == ' ' || c == '#' || c == '0';
+    }
+
+    bool isLengthModifier(char c)
+    {
+        return c == 'h' || c == 'l' || c == 'L' || c == 'j' || c == 'z' || c == 't' || c == 'q';
+    }
+
+    int64_t asInt(const LogManager::LogArg &arg)
+    {
+        switch (arg.type) {
+        case LogManager::ArgType::Int: return arg.i;
+        case LogManager::ArgType::UInt: return (int64_t)arg.u;
+        case LogManager::ArgType::Double: return (int64_t)arg.d;
+        case LogManager::ArgType::Pointer: return (int64_t)(intptr_t)arg.p;
+        case LogManager::ArgType::String: return 0;
+        }
+        return 0;
+    }
+
+    uint64_t asUInt(const LogManager::LogArg &arg)
+    {
+        return arg.type == LogManager::ArgType::UInt ? arg.u : (uint64_t)asInt(arg);
+    }
+
+    double asDouble(const LogManager::LogArg &arg)
+    {
+        switch (arg.type) {
+        case LogManager::ArgType::Int: return (double)arg.i;
+        case LogManager::ArgType::UInt: return (double)arg.u;
+        case LogManager::ArgType::Double: return arg.d;
+        default: return 0.0;
+        }
+    }
+}
+
+namespace LogManager
+{
+    size_t formatMessage(const char *fmt, const LogArg *args, size_t argCount,
+                         const char *strings, size_t stringBytes, char *out, size_t outSize)
+    {
+        if (!out || outSize == 0) {
+            return 0;
+        }
+        out[0] = '\0';
+        if (!fmt) {
+            return 0;
+        }
+
+        OutputBuffer buffer{out, outSize};
+        size_t nextArg = 0;
+        const char *p = fmt;
+
+        while (*p) {
+            const char *literal = p;
+            while (*p && *p != '%') {
+                ++p;
+            }
+            buffer.append(literal, (size_t)(p - literal));
+            if (!*p) {
+                break;
+            }
+
+            const char *specStart = p++;
+            if (*p == '%') {
+                buffer.append("%", 1);
+                ++p;
+                continue;
+            }
+
+            char spec[32];
+            size_t specLength = 0;
+            spec[specLength++] = '%';
+
+            while (isFlag(*p) && specLength < 8) {
+                spec[specLength++] = *p++;
+            }
+
+            bool starWidth = false;
+            int width = 0;
+            if (*p == '*') {
+                starWidth = true;
+                spec[specLength++] = *p++;
+                if (nextArg < argCount) {
+                    width = (int)asInt(args[nextArg++]);
+                }
+            } else {
+                while (*p >= '0' && *p <= '9' && specLength < 16) {
+                    spec[specLength++] = *p++;
+                }
+            }
+
+            if (*p == '.') {
+                spec[specLength++] = *p++;
+                while (*p >= '0' && *p <= '9' && specLength < 24) {
+                    spec[specLength++] = *p++;
+                }
+            }
+
+            while (isLengthModifier(*p)) {
+                ++p;
+            }
+
+            char conversion = *p;
+            if (!conversion) {
+                buffer.append(specStart, (size_t)(p - specStart));
+                break;
+            }
+            ++p;
+
+            if (conversion == 'n') {
+                continue;
+            }
+
+            if (nextArg >= argCount) {
+                buffer.append(specStart, (size_t)(p - specStart));
+                continue;
+            }
+            const LogArg &arg = args[nextArg++];
+
+            switch (conversion) {
+            case 'd':
+            case 'i':
+                spec[specLength++] = 'l';
+                spec[specLength++] = 'l';
+                spec[specLength++] = conversion;
+                spec[specLength] = '\0';
+                if (starWidth) buffer.appendFormatted(spec, width, (long long)asInt(arg));
+                else buffer.appendFormatted(spec, (long long)asInt(arg));
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                spec[specLength++] = 'l';
+                spec[specLength++] = 'l';
+                spec[specLength++] = conversion;
+                spec[specLength] = '\0';
+                if (starWidth) buffer.appendFormatted(spec, width, (unsigned long long)asUInt(arg));
+                else buffer.appendFormatted(spec, (unsigned long long)asUInt(arg));
+                break;
+            case 'c':
+                spec[specLength++] = 'c';
+                spec[specLength] = '\0';
+                if (starWidth) buffer.appendFormatted(spec, width, (int)asInt(arg));
+                else buffer.appendFormatted(spec, (int)asInt(arg));
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                spec[specLength++] = conversion;
+                spec[specLength] = '\0';
+                if (starWidth) buffer.appendFormatted(spec, width, asDouble(arg));
+                else buffer.appendFormatted(spec, asDouble(arg));
+                break;
+            case 's': {
+                spec[specLength++] = 's';
+                spec[specLength] = '\0';
+                const char *text = "(invalid)";
+                if (arg.type == ArgType::String && strings &&
+                    (size_t)arg.s.offset + arg.s.length < stringBytes &&
+                    strings[arg.s.offset + arg.s.length] == '\0') {
+                    text = strings + arg.s.offset;
+                } else if (arg.type == ArgType::Pointer && !arg.p) {
+                    text = "(null)";
+                }
+                if (starWidth) buffer.appendFormatted(spec, width, text);
+                else buffer.appendFormatted(spec, text);
+                break;
+            }
+            case 'p':
+                spec[specLength++] = 'p';
+                spec[specLength] = '\0';
+                if (starWidth) buffer.appendFormatted(spec, width, arg.type == ArgType::Pointer ? arg.p : nullptr);
+                else buffer.appendFormatted(spec, arg.type == ArgType::Pointer ? arg.p : nullptr);
+                break;
+            default:
+                buffer.append(specStart, (size_t)(p - specStart));
+                break;
+            }
+        }
+
+        return buffer.length;
+    }
+}
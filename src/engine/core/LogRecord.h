@@ -0,0 +1,194 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace LogManager
+{
+    enum class Level : uint8_t { Info, Debug, Error };
+
+    enum class ArgType : uint8_t { Int, UInt, Double, Pointer, String };
+
+    // FNV-1a step over a string plus its terminator, so ("ab", "c") and
+    // ("a", "bc") hash differently.
+    constexpr uint64_t hashString(uint64_t hash, const char *text)
+    {
+        for (const char *c = text; c && *c; ++c) {
+            hash = (hash ^ (uint8_t)*c) * 1099511628211ull;
+        }
+        return hash * 1099511628211ull;
+    }
+
+    // Identifies a log call in binary captures. File and line alone collide
+    // for several calls on one line (or a macro expanding to several), so
+    // the level, tag and format are mixed in; sites that still share an id
+    // are identical and decode the same way.
+    constexpr uint64_t siteId(const char *file, uint32_t line, Level level, const char *tag, const char *fmt)
+    {
+        uint64_t hash = hashString(14695981039346656037ull, file);
+        for (int i = 0; i < 4; ++i) {
+            hash = (hash ^ ((line >> (i * 8)) & 0xFF)) * 1099511628211ull;
+        }
+        hash = (hash ^ (uint8_t)level) * 1099511628211ull;
+        hash = hashString(hash ^ (tag ? 1u : 0u), tag);
+        return hashString(hash, fmt);
+    }
+
+    // Filter slots: one per known tag, plus untagged and any other tag.
+    enum class TagSlot : uint8_t { None, Construct, Destroy, Start, Finish, Shader, Step, Other, Count };
+
+    constexpr size_t LEVEL_COUNT = 3;
+    constexpr size_t TAG_SLOT_COUNT = (size_t)TagSlot::Count;
+
+    constexpr bool tagEquals(const char *a, const char *b)
+    {
+        while (*a && *a == *b) {
+            ++a;
+            ++b;
+        }
+        return *a == *b;
+    }
+
+    constexpr TagSlot tagSlot(const char *tag)
+    {
+        if (!tag) return TagSlot::None;
+        if (tagEquals(tag, "CONSTRUCT")) return TagSlot::Construct;
+        if (tagEquals(tag, "DESTROY")) return TagSlot::Destroy;
+        if (tagEquals(tag, "START")) return TagSlot::Start;
+        if (tagEquals(tag, "FINISH")) return TagSlot::Finish;
+        if (tagEquals(tag, "SHADER")) return TagSlot::Shader;
+        if (tagEquals(tag, "STEP")) return TagSlot::Step;
+        return TagSlot::Other;
+    }
+
+    constexpr uint64_t filterBit(Level level, TagSlot slot)
+    {
+        return 1ull << ((size_t)level * TAG_SLOT_COUNT + (size_t)slot);
+    }
+
+    struct Site
+    {
+        constexpr Site(Level level, const char *tag, const char *fmt, const char *file, uint32_t line)
+            : level(level), tag(tag), fmt(fmt), file(file), line(line), id(siteId(file, line, level, tag, fmt)),
+              filterBit(LogManager::filterBit(level, tagSlot(tag))) {}
+
+        Site(const Site &) = delete;
+        Site &operator=(const Site &) = delete;
+
+        const Level level;
+        const char *const tag;
+        const char *const fmt;
+        const char *const file;
+        const uint32_t line;
+        const uint64_t id;
+        const uint64_t filterBit;
+        std::atomic<uint32_t> captureGeneration{0};
+    };
+
+    struct LogArg
+    {
+        ArgType type;
+        union {
+            int64_t i;
+            uint64_t u;
+            double d;
+            const void *p;
+            struct {
+                uint16_t offset;
+                uint16_t length;
+            } s;
+        };
+    };
+
+    struct LogRecord
+    {
+        static constexpr size_t MAX_ARGS = 12;
+        static constexpr size_t STRING_BYTES = 256;
+
+        int64_t monotonicNs;
+        const Site *site;
+        uint8_t argCount;
+        uint16_t stringBytes;
+        LogArg args[MAX_ARGS];
+        char strings[STRING_BYTES];
+    };
+
+    inline void encodeString(LogRecord &record, LogArg &arg, const char *value)
+    {
+        if (!value) {
+            value = "(null)";
+        }
+
+        arg.type = ArgType::String;
+
+        // The last byte is kept back as a shared terminator: once nothing
+        // else fits, string arguments become empty strings pointing at it.
+        constexpr size_t sharedEmpty = LogRecord::STRING_BYTES - 1;
+        if (record.stringBytes >= sharedEmpty) {
+            record.strings[sharedEmpty] = '\0';
+            record.stringBytes = (uint16_t)LogRecord::STRING_BYTES;
+            arg.s.offset = (uint16_t)sharedEmpty;
+            arg.s.length = 0;
+            return;
+        }
+
+        size_t available = sharedEmpty - record.stringBytes;
+        size_t length = std::strlen(value);
+        if (length >= available) {
+            length = available - 1;
+        }
+
+        arg.s.offset = record.stringBytes;
+        arg.s.length = (uint16_t)length;
+        std::memcpy(record.strings + record.stringBytes, value, length);
+        record.strings[record.stringBytes + length] = '\0';
+        record.stringBytes += (uint16_t)(length + 1);
+    }
+
+    template <typename T>
+    inline void encodeArg(LogRecord &record, T value)
+    {
+        LogArg &arg = record.args[record.argCount++];
+
+        if constexpr (std::is_same_v<T, bool>) {
+            arg.type = ArgType::Int;
+            arg.i = value ? 1 : 0;
+        } else if constexpr (std::is_enum_v<T>) {
+            arg.type = ArgType::Int;
+            arg.i = (int64_t)value;
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            arg.type = ArgType::Int;
+            arg.i = (int64_t)value;
+        } else if constexpr (std::is_integral_v<T>) {
+            arg.type = ArgType::UInt;
+            arg.u = (uint64_t)value;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            arg.type = ArgType::Double;
+            arg.d = (double)value;
+        } else if constexpr (std::is_same_v<T, const char *> || std::is_same_v<T, char *>) {
+            encodeString(record, arg, value);
+        } else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+            arg.type = ArgType::Pointer;
+            arg.p = (const void *)value;
+        } else {
+            static_assert(std::is_pointer_v<T>, "Unsupported log argument type");
+        }
+    }
+
+    template <typename... Args>
+    inline void encodeArgs(LogRecord &record, Args... args)
+    {
+        static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "Too many log arguments");
+        record.argCount = 0;
+        record.stringBytes = 0;
+        (encodeArg(record, args), ...);
+    }
+
+    // String arguments outside the first stringBytes of `strings`, or not
+    // terminated where their length says, print as "(invalid)".
+    size_t formatMessage(const char *fmt, const LogArg *args, size_t argCount,
+                         const char *strings, size_t stringBytes, char *out, size_t outSize);
+}
@@ -0,0 +1,229 @@
+#include "engine/core/LogSink.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+    const char *kReset = "\033[0m";
+    const char *kRed = "\033[0;31m";
+    const char *kGreen = "\033[0;32m";
+    const char *kYellow = "\033[1;33m";
+    const char *kBlue = "\033[0;34m";
+    const char *kMagenta = "\033[0;35m";
+    const char *kCyan = "\033[0;36m";
+
+    const char *levelPrefix(LogManager::Level level)
+    {
+        switch (level)
+        {
+        case LogManager::Level::Info:
+            return kGreen;
+        case LogManager::Level::Debug:
+            return kYellow;
+        case LogManager::Level::Error:
+            return kRed;
+        }
+        return kReset;
+    }
+
+    const char *tagColor(const char *tag)
+    {
+        switch (LogManager::tagSlot(tag))
+        {
+        case LogManager::TagSlot::Construct:
+            return kMagenta;
+        case LogManager::TagSlot::Destroy:
+            return kRed;
+        case LogManager::TagSlot::Start:
+            return kBlue;
+        case LogManager::TagSlot::Finish:
+            return kGreen;
+        case LogManager::TagSlot::Shader:
+            return kCyan;
+        case LogManager::TagSlot::Step:
+            return kYellow;
+        default:
+            return kReset;
+        }
+    }
+
+    void appendLine(const LogManager::LogLine &line, bool color, std::string &out)
+    {
+        if (color) out += levelPrefix(line.level);
+        out += "[";
+        out += LogManager::levelName(line.level);
+        out += "] ";
+        if (color) out += kReset;
+        out += line.timestamp;
+        if (line.tag) {
+            out += " ";
+            if (color) out += tagColor(line.tag);
+            out += "[";
+            out += line.tag;
+            out += "] ";
+            if (color) out += kReset;
+            out += "- ";
+        } else {
+            out += " - ";
+        }
+        out += line.message;
+        out += "\n";
+    }
+
+    int64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+}
+
+namespace LogManager
+{
+    const char *levelName(Level level)
+    {
+        switch (level)
+        {
+        case Level::Info:
+            return "INFO";
+        case Level::Debug:
+            return "DEBUG";
+        case Level::Error:
+            return "ERROR";
+        }
+        return "";
+    }
+
+    ConsoleSink::ConsoleSink(FILE *stream, bool color) : stream(stream), color(color) {}
+
+    void ConsoleSink::write(const LogLine &line)
+    {
+        appendLine(line, color, buffer);
+    }
+
+    void ConsoleSink::flush()
+    {
+        if (buffer.empty()) {
+            return;
+        }
+        std::fwrite(buffer.data(), 1, buffer.size(), stream);
+        std::fflush(stream);
+        buffer.clear();
+    }
+
+    RotatingFileSink::RotatingFileSink(const std::string &path, size_t maxBytes, double maxAgeSeconds, int maxFiles)
+        : path(path),
+          maxBytes(maxBytes),
+          maxAgeNs((int64_t)(maxAgeSeconds * 1e9)),
+          maxFiles(maxFiles < 1 ? 1 : maxFiles)
+    {
+        open();
+    }
+
+    RotatingFileSink::~RotatingFileSink()
+    {
+        flush();
+        if (file) {
+            std::fclose(file);
+        }
+    }
+
+    void RotatingFileSink::open()
+    {
+        file = std::fopen(path.c_str(), "a");
+        if (!file) {
+            std::fprintf(stderr, "RotatingFileSink: failed to open %s\n", path.c_str());
+            return;
+        }
+        std::fseek(file, 0, SEEK_END);
+        long position = std::ftell(file);
+        fileBytes = position > 0 ? (size_t)position : 0;
+        openedNs = nowNs();
+    }
+
+    void RotatingFileSink::rotate()
+    {
+        if (file) {
+            std::fclose(file);
+            file = nullptr;
+        }
+
+        std::remove((path + "." + std::to_string(maxFiles)).c_str());
+        for (int i = maxFiles - 1; i >= 1; --i) {
+            std::rename((path + "." + std::to_string(i)).c_str(), (path + "." + std::to_string(i + 1)).c_str());
+        }
+        std::rename(path.c_str(), (path + ".1").c_str());
+
+        open();
+    }
+
+    void RotatingFileSink::write(const LogLine &line)
+    {
+        appendLine(line, false, buffer);
+    }
+
+    void RotatingFileSink::flush()
+    {
+        if (buffer.empty()) {
+            return;
+        }
+
+        bool tooLarge = maxBytes > 0 && fileBytes > 0 && fileBytes + buffer.size() > maxBytes;
+        bool tooOld = maxAgeNs > 0 && nowNs() - openedNs > maxAgeNs;
+        if (!file || tooLarge || tooOld) {
+            rotate();
+        }
+        if (!file) {
+            buffer.clear();
+            return;
+        }
+
+        std::fwrite(buffer.data(), 1, buffer.size(), file);
+        std::fflush(file);
+        fileBytes += buffer.size();
+        buffer.clear();
+    }
+
+    RingBufferSink::RingBufferSink(size_t capacity) : entries(capacity > 0 ? capacity : 1) {}
+
+    void RingBufferSink::write(const LogLine &line)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry &entry = entries[(head + count) % entries.size()];
+        entry.level = line.level;
+        entry.tag.assign(line.tag ? line.tag : "");
+        entry.timestampNs = line.timestampNs;
+        entry.message.assign(line.message);
+        if (count < entries.size()) {
+            ++count;
+        } else {
+            head = (head + 1) % entries.size();
+        }
+        ++written;
+    }
+
+    std::vector<RingBufferSink::Entry> RingBufferSink::snapshot() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<Entry> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            result.push_back(entries[(head + i) % entries.size()]);
+        }
+        return result;
+    }
+
+    uint64_t RingBufferSink::sequence() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return written;
+    }
+
+    void RingBufferSink::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        head = 0;
+        count = 0;
+        ++written;
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "engine/core/LogRecord.h"
+
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace LogManager
+{
+    struct LogLine
+    {
+        Level level;
+        const char *tag;
+        int64_t timestampNs;
+        const char *timestamp;
+        const char *message;
+    };
+
+    // Sinks are driven from the logging thread only: write() is called once
+    // per line and flush() once per batch.
+    class LogSink
+    {
+    public:
+        virtual ~LogSink() = default;
+        virtual void write(const LogLine &line) = 0;
+        virtual void flush() {}
+    };
+
+    class ConsoleSink : public LogSink
+    {
+    public:
+        explicit ConsoleSink(FILE *stream = stdout, bool color = true);
+
+        void write(const LogLine &line) override;
+        void flush() override;
+
+    private:
+        FILE *stream;
+        bool color;
+        std::string buffer;
+    };
+
+    class RotatingFileSink : public LogSink
+    {
+    public:
+        // The active file is rotated to path.1 (shifting older files up to
+        // path.<maxFiles>) when it exceeds maxBytes or is older than
+        // maxAgeSeconds. A limit of zero disables that check.
+        RotatingFileSink(const std::string &path, size_t maxBytes, double maxAgeSeconds, int maxFiles);
+        ~RotatingFileSink() override;
+
+        void write(const LogLine &line) override;
+        void flush() override;
+
+        bool isOpen() const { return file != nullptr; }
+
+    private:
+        void open();
+        void rotate();
+
+        std::string path;
+        size_t maxBytes;
+        int64_t maxAgeNs;
+        int maxFiles;
+        FILE *file = nullptr;
+        size_t fileBytes = 0;
+        int64_t openedNs = 0;
+        std::string buffer;
+    };
+
+    class RingBufferSink : public LogSink
+    {
+    public:
+        struct Entry
+        {
+            Level level;
+            std::string tag;
+            int64_t timestampNs;
+            std::string message;
+        };
+
+        explicit RingBufferSink(size_t capacity);
+
+        void write(const LogLine &line) override;
+
+        // Oldest first. Safe to call from any thread.
+        std::vector<Entry> snapshot() const;
+        // Bumped on every write so readers can skip unchanged snapshots.
+        uint64_t sequence() const;
+        void clear();
+
+    private:
+        mutable std::mutex mutex;
+        std::vector<Entry> entries;
+        size_t head = 0;
+        size_t count = 0;
+        uint64_t written = 0;
+    };
+
+    const char *levelName(Level level);
+}
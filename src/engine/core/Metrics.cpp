@@ -0,0 +1,292 @@
+#include "engine/core/Metrics.h"
+#include "engine/core/LogManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace
+{
+    struct ThreadCounters
+    {
+        std::atomic<uint64_t> counts[Metrics::MAX_COUNTERS] = {};
+    };
+
+    struct Entry
+    {
+        std::string name;
+        Metrics::Kind kind;
+        uint32_t slot = UINT32_MAX;
+        std::atomic<double> *gauge = nullptr;
+        Metrics::HistogramData *histogram = nullptr;
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<Entry> entries;
+        uint32_t counterSlots = 0;
+        std::vector<ThreadCounters *> threads;
+        uint64_t retired[Metrics::MAX_COUNTERS] = {};
+        uint64_t totals[Metrics::MAX_COUNTERS] = {};
+        std::atomic<uint64_t> frameValues[Metrics::MAX_COUNTERS] = {};
+    };
+
+    Registry &registry()
+    {
+        static Registry *instance = new Registry();
+        return *instance;
+    }
+
+    // Folds the thread's counts into the retired totals when it exits so
+    // nothing is lost between frames.
+    struct ThreadCountersHandle
+    {
+        ThreadCounters *counters;
+
+        ThreadCountersHandle() : counters(new ThreadCounters())
+        {
+            Registry &reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.threads.push_back(counters);
+        }
+
+        ~ThreadCountersHandle()
+        {
+            Registry &reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            for (size_t i = 0; i < Metrics::MAX_COUNTERS; ++i) {
+                reg.retired[i] += counters->counts[i].load(std::memory_order_relaxed);
+            }
+            reg.threads.erase(std::remove(reg.threads.begin(), reg.threads.end(), counters), reg.threads.end());
+            delete counters;
+        }
+    };
+
+    ThreadCounters &threadCounters()
+    {
+        thread_local ThreadCountersHandle handle;
+        return *handle.counters;
+    }
+
+    Entry *findEntry(Registry &reg, const char *name)
+    {
+        for (Entry &entry : reg.entries) {
+            if (entry.name == name) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    void fillValue(const Registry &reg, const Entry &entry, Metrics::Value &value)
+    {
+        value.name = entry.name;
+        value.kind = entry.kind;
+        switch (entry.kind)
+        {
+        case Metrics::Kind::Counter:
+            value.frame = (double)reg.frameValues[entry.slot].load(std::memory_order_relaxed);
+            value.total = (double)reg.totals[entry.slot];
+            break;
+        case Metrics::Kind::Gauge:
+            value.frame = entry.gauge->load(std::memory_order_relaxed);
+            value.total = value.frame;
+            break;
+        case Metrics::Kind::Histogram:
+            value.frame = entry.histogram->mean();
+            value.total = (double)entry.histogram->count();
+            value.p50 = entry.histogram->percentile(0.50);
+            value.p95 = entry.histogram->percentile(0.95);
+            value.p99 = entry.histogram->percentile(0.99);
+            value.max = entry.histogram->max();
+            break;
+        }
+    }
+}
+
+namespace Metrics
+{
+    void Counter::add(uint64_t amount) const
+    {
+        if (slot >= MAX_COUNTERS) {
+            return;
+        }
+        std::atomic<uint64_t> &count = threadCounters().counts[slot];
+        count.store(count.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    uint64_t Counter::frameValue() const
+    {
+        if (slot >= MAX_COUNTERS) {
+            return 0;
+        }
+        return registry().frameValues[slot].load(std::memory_order_relaxed);
+    }
+
+    int HistogramData::bucketIndex(uint64_t units)
+    {
+        if (units < (uint64_t)SUB_BUCKETS) {
+            return (int)units;
+        }
+        int msb = 63 - __builtin_clzll(units);
+        int magnitude = msb - 3;
+        if (magnitude >= MAGNITUDES) {
+            return BUCKETS - 1;
+        }
+        int sub = (int)((units >> (msb - 4)) & (SUB_BUCKETS - 1));
+        return magnitude * SUB_BUCKETS + sub;
+    }
+
+    uint64_t HistogramData::bucketValue(int index)
+    {
+        int magnitude = index / SUB_BUCKETS;
+        int sub = index % SUB_BUCKETS;
+        if (magnitude == 0) {
+            return (uint64_t)sub;
+        }
+        int shift = magnitude - 1;
+        uint64_t lower = (uint64_t)(SUB_BUCKETS + sub) << shift;
+        return lower + ((1ull << shift) >> 1);
+    }
+
+    void HistogramData::record(double value)
+    {
+        uint64_t units = value > 0.0 ? (uint64_t)std::llround(value * scale) : 0;
+        buckets[bucketIndex(units)].fetch_add(1, std::memory_order_relaxed);
+        samples.fetch_add(1, std::memory_order_relaxed);
+        sumUnits.fetch_add(units, std::memory_order_relaxed);
+
+        uint64_t seen = maxUnits.load(std::memory_order_relaxed);
+        while (units > seen && !maxUnits.compare_exchange_weak(seen, units, std::memory_order_relaxed)) {
+        }
+    }
+
+    double HistogramData::percentile(double p) const
+    {
+        uint64_t total = samples.load(std::memory_order_relaxed);
+        if (total == 0) {
+            return 0.0;
+        }
+        uint64_t target = (uint64_t)std::ceil(p * (double)total);
+        if (target == 0) {
+            target = 1;
+        }
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target) {
+                return std::min(bucketValue(i), maxUnits.load(std::memory_order_relaxed)) / scale;
+            }
+        }
+        return max();
+    }
+
+    double HistogramData::mean() const
+    {
+        uint64_t total = samples.load(std::memory_order_relaxed);
+        return total ? (double)sumUnits.load(std::memory_order_relaxed) / (double)total / scale : 0.0;
+    }
+
+    double HistogramData::max() const
+    {
+        return (double)maxUnits.load(std::memory_order_relaxed) / scale;
+    }
+
+    void HistogramData::reset()
+    {
+        for (auto &bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        samples.store(0, std::memory_order_relaxed);
+        sumUnits.store(0, std::memory_order_relaxed);
+        maxUnits.store(0, std::memory_order_relaxed);
+    }
+
+    Counter counter(const char *name)
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        if (Entry *entry = findEntry(reg, name)) {
+            return entry->kind == Kind::Counter ? Counter(entry->slot) : Counter();
+        }
+        if (reg.counterSlots >= MAX_COUNTERS) {
+            LOG_ERROR("Metrics: counter limit reached, ignoring %s", name);
+            return Counter();
+        }
+        Entry entry;
+        entry.name = name;
+        entry.kind = Kind::Counter;
+        entry.slot = reg.counterSlots++;
+        reg.entries.push_back(entry);
+        return Counter(entry.slot);
+    }
+
+    Gauge gauge(const char *name)
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        if (Entry *entry = findEntry(reg, name)) {
+            return entry->kind == Kind::Gauge ? Gauge(entry->gauge) : Gauge();
+        }
+        Entry entry;
+        entry.name = name;
+        entry.kind = Kind::Gauge;
+        entry.gauge = new std::atomic<double>(0.0);
+        reg.entries.push_back(entry);
+        return Gauge(entry.gauge);
+    }
+
+    Histogram histogram(const char *name, double scale)
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        if (Entry *entry = findEntry(reg, name)) {
+            return entry->kind == Kind::Histogram ? Histogram(entry->histogram) : Histogram();
+        }
+        Entry entry;
+        entry.name = name;
+        entry.kind = Kind::Histogram;
+        entry.histogram = new HistogramData(scale);
+        reg.entries.push_back(entry);
+        return Histogram(entry.histogram);
+    }
+
+    void endFrame()
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (uint32_t slot = 0; slot < reg.counterSlots; ++slot) {
+            uint64_t sum = reg.retired[slot];
+            for (ThreadCounters *thread : reg.threads) {
+                sum += thread->counts[slot].load(std::memory_order_relaxed);
+            }
+            reg.frameValues[slot].store(sum - reg.totals[slot], std::memory_order_relaxed);
+            reg.totals[slot] = sum;
+        }
+    }
+
+    std::vector<Value> snapshot()
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        std::vector<Value> values(reg.entries.size());
+        for (size_t i = 0; i < reg.entries.size(); ++i) {
+            fillValue(reg, reg.entries[i], values[i]);
+        }
+        return values;
+    }
+
+    bool find(const std::string &name, Value &out)
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const Entry &entry : reg.entries) {
+            if (entry.name == name) {
+                fillValue(reg, entry, out);
+                return true;
+            }
+        }
+        return false;
+    }
+}
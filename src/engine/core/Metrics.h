@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Metrics
+{
+    enum class Kind : uint8_t { Counter, Gauge, Histogram };
+
+    constexpr size_t MAX_COUNTERS = 128;
+
+    // Adds go to a slot owned by the calling thread; endFrame() folds all
+    // threads into per-frame and running totals.
+    class Counter
+    {
+    public:
+        Counter() = default;
+        explicit Counter(uint32_t slot) : slot(slot) {}
+
+        void add(uint64_t amount = 1) const;
+        // Total added during the frame closed by the last endFrame().
+        uint64_t frameValue() const;
+
+    private:
+        uint32_t slot = UINT32_MAX;
+    };
+
+    class Gauge
+    {
+    public:
+        Gauge() = default;
+        explicit Gauge(std::atomic<double> *value) : value(value) {}
+
+        void set(double v) const
+        {
+            if (value) value->store(v, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<double> *value = nullptr;
+    };
+
+    // Log-linear buckets: 16 linear steps per power of two, so any recorded
+    // value lands in a bucket within ~6% of it. Values are stored in
+    // integer units of 1/scale (e.g. scale 1000 for milliseconds recorded
+    // at microsecond resolution).
+    class HistogramData
+    {
+    public:
+        static constexpr int SUB_BUCKETS = 16;
+        static constexpr int MAGNITUDES = 44;
+        static constexpr int BUCKETS = SUB_BUCKETS * MAGNITUDES;
+
+        explicit HistogramData(double scale) : scale(scale) {}
+
+        void record(double value);
+        double percentile(double p) const;
+        double mean() const;
+        double max() const;
+        uint64_t count() const { return samples.load(std::memory_order_relaxed); }
+        void reset();
+
+        static int bucketIndex(uint64_t units);
+        static uint64_t bucketValue(int index);
+
+    private:
+        double scale;
+        std::atomic<uint64_t> buckets[BUCKETS] = {};
+        std::atomic<uint64_t> samples{0};
+        std::atomic<uint64_t> sumUnits{0};
+        std::atomic<uint64_t> maxUnits{0};
+    };
+
+    class Histogram
+    {
+    public:
+        Histogram() = default;
+        explicit Histogram(HistogramData *data) : data(data) {}
+
+        void record(double value) const
+        {
+            if (data) data->record(value);
+        }
+
+    private:
+        HistogramData *data = nullptr;
+    };
+
+    // Lookups take a lock; resolve once and keep the handle (the METRIC_*
+    // macros cache it in a static).
+    Counter counter(const char *name);
+    Gauge gauge(const char *name);
+    Histogram histogram(const char *name, double scale = 1000.0);
+
+    void endFrame();
+
+    struct Value
+    {
+        std::string name;
+        Kind kind;
+        double frame = 0.0;   // counters: last frame; gauges: current value
+        double total = 0.0;   // counters: since start; histograms: sample count
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    std::vector<Value> snapshot();
+    bool find(const std::string &name, Value &out);
+}
+
+#define METRIC_COUNT(name, amount) \
+    do { \
+        static const Metrics::Counter metric_ = Metrics::counter(name); \
+        metric_.add(amount); \
+    } while (0)
+
+#define METRIC_GAUGE(name, value) \
+    do { \
+        static const Metrics::Gauge metric_ = Metrics::gauge(name); \
+        metric_.set(value); \
+    } while (0)
+
+#define METRIC_HISTOGRAM(name, value) \
+    do { \
+        static const Metrics::Histogram metric_ = Metrics::histogram(name); \
+        metric_.record(value); \
+    } while (0)
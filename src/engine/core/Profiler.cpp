@@ -0,0 +1,244 @@
+#include "engine/core/Profiler.h"
+#include "engine/core/LogManager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    enum class EventKind : uint8_t { Zone, Frame };
+
+    struct Event
+    {
+        const char *name;
+        int64_t startNs;
+        int64_t endNs;
+        uint64_t frame;
+        EventKind kind;
+    };
+
+    // Written only by its owning thread. count is the number of events
+    // recorded this capture; the ring holds the last events.size() of them.
+    struct ThreadBuffer
+    {
+        uint32_t threadId = 0;
+        std::atomic<const char *> name{nullptr};
+        uint32_t generation = 0;
+        std::atomic<uint32_t> publishedGeneration{0};
+        std::atomic<size_t> count{0};
+        std::vector<Event> events;
+    };
+
+    std::atomic<bool> g_capturing{false};
+    std::atomic<size_t> g_events_per_thread{Profiler::DEFAULT_EVENTS_PER_THREAD};
+    std::atomic<uint32_t> g_generation{0};
+    std::atomic<uint64_t> g_frame{0};
+    int64_t g_capture_start_ns = 0;
+
+    std::mutex g_registry_mutex;
+    std::vector<ThreadBuffer *> &registry()
+    {
+        static auto *buffers = new std::vector<ThreadBuffer *>();
+        return *buffers;
+    }
+
+    // Buffers of exited threads; reused once their events are no longer
+    // part of the current capture.
+    std::vector<ThreadBuffer *> &retired()
+    {
+        static auto *buffers = new std::vector<ThreadBuffer *>();
+        return *buffers;
+    }
+
+    ThreadBuffer *acquireBuffer()
+    {
+        std::lock_guard<std::mutex> lock(g_registry_mutex);
+        uint32_t generation = g_generation.load(std::memory_order_acquire);
+        auto &free = retired();
+        for (size_t i = 0; i < free.size(); ++i) {
+            if (free[i]->publishedGeneration.load(std::memory_order_relaxed) != generation) {
+                ThreadBuffer *buffer = free[i];
+                free.erase(free.begin() + (long)i);
+                buffer->name.store(nullptr, std::memory_order_relaxed);
+                return buffer;
+            }
+        }
+
+        auto *created = new ThreadBuffer();
+        created->threadId = (uint32_t)registry().size() + 1;
+        registry().push_back(created);
+        return created;
+    }
+
+    struct ThreadBufferHandle
+    {
+        ThreadBuffer *buffer = acquireBuffer();
+
+        ~ThreadBufferHandle()
+        {
+            std::lock_guard<std::mutex> lock(g_registry_mutex);
+            retired().push_back(buffer);
+        }
+    };
+
+    ThreadBuffer &threadBuffer()
+    {
+        thread_local ThreadBufferHandle handle;
+        return *handle.buffer;
+    }
+
+    void record(const Event &event)
+    {
+        ThreadBuffer &buffer = threadBuffer();
+        uint32_t generation = g_generation.load(std::memory_order_acquire);
+        if (buffer.generation != generation) {
+            size_t capacity = g_events_per_thread.load(std::memory_order_relaxed);
+            if (buffer.events.size() != capacity) {
+                buffer.events.assign(capacity, Event{});
+            }
+            buffer.generation = generation;
+            buffer.count.store(0, std::memory_order_relaxed);
+            buffer.publishedGeneration.store(generation, std::memory_order_release);
+        }
+
+        size_t index = buffer.count.load(std::memory_order_relaxed);
+        buffer.events[index % buffer.events.size()] = event;
+        buffer.count.store(index + 1, std::memory_order_release);
+    }
+
+    void writeEscaped(FILE *file, const char *text)
+    {
+        for (const char *c = text ? text : "?"; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                std::fputc('\\', file);
+                std::fputc(*c, file);
+            } else if ((unsigned char)*c < 0x20) {
+                std::fprintf(file, "\\u%04x", (unsigned)*c);
+            } else {
+                std::fputc(*c, file);
+            }
+        }
+    }
+}
+
+namespace Profiler
+{
+    int64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void beginCapture(size_t eventsPerThread)
+    {
+        g_events_per_thread.store(eventsPerThread > 0 ? eventsPerThread : DEFAULT_EVENTS_PER_THREAD,
+                                  std::memory_order_relaxed);
+        g_capture_start_ns = nowNs();
+        g_frame.store(0, std::memory_order_relaxed);
+        g_generation.fetch_add(1, std::memory_order_acq_rel);
+        g_capturing.store(true, std::memory_order_release);
+    }
+
+    void endCapture()
+    {
+        g_capturing.store(false, std::memory_order_release);
+    }
+
+    bool isCapturing()
+    {
+        return g_capturing.load(std::memory_order_relaxed);
+    }
+
+    void setThreadName(const char *name)
+    {
+        threadBuffer().name.store(name, std::memory_order_release);
+    }
+
+    void recordZone(const char *name, int64_t startNs, int64_t endNs)
+    {
+        if (!g_capturing.load(std::memory_order_relaxed)) {
+            return;
+        }
+        record(Event{name, startNs, endNs, 0, EventKind::Zone});
+    }
+
+    void markFrame()
+    {
+        if (!g_capturing.load(std::memory_order_relaxed)) {
+            return;
+        }
+        int64_t now = nowNs();
+        record(Event{"Frame", now, now, g_frame.fetch_add(1, std::memory_order_relaxed), EventKind::Frame});
+    }
+
+    bool writeChromeTrace(const char *path)
+    {
+        FILE *file = std::fopen(path, "w");
+        if (!file) {
+            LOG_ERROR("Profiler: failed to open %s", path);
+            return false;
+        }
+
+        uint32_t generation = g_generation.load(std::memory_order_acquire);
+        size_t written = 0;
+        uint64_t overwritten = 0;
+        bool first = true;
+        auto separator = [&] {
+            std::fputs(first ? "\n" : ",\n", file);
+            first = false;
+        };
+
+        std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+
+        std::lock_guard<std::mutex> lock(g_registry_mutex);
+        for (ThreadBuffer *buffer : registry()) {
+            if (buffer->publishedGeneration.load(std::memory_order_acquire) != generation) {
+                continue;
+            }
+
+            separator();
+            std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                         buffer->threadId);
+            const char *name = buffer->name.load(std::memory_order_acquire);
+            if (name) {
+                writeEscaped(file, name);
+            } else {
+                std::fprintf(file, "Thread %u", buffer->threadId);
+            }
+            std::fputs("\"}}", file);
+
+            size_t count = buffer->count.load(std::memory_order_acquire);
+            size_t capacity = buffer->events.size();
+            size_t oldest = count > capacity ? count - capacity : 0;
+            overwritten += oldest;
+            for (size_t i = oldest; i < count; ++i) {
+                const Event &event = buffer->events[i % capacity];
+                double ts = (double)(event.startNs - g_capture_start_ns) / 1000.0;
+                separator();
+                if (event.kind == EventKind::Frame) {
+                    std::fprintf(file, "{\"name\":\"Frame %llu\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                                 (unsigned long long)event.frame, buffer->threadId, ts);
+                } else {
+                    std::fputs("{\"name\":\"", file);
+                    writeEscaped(file, event.name);
+                    std::fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                                 buffer->threadId, ts, (double)(event.endNs - event.startNs) / 1000.0);
+                }
+                ++written;
+            }
+        }
+
+        std::fputs("\n]}\n", file);
+        std::fclose(file);
+
+        LOG_INFO("Profiler: wrote %zu events to %s", written, path);
+        if (overwritten > 0) {
+            LOG_INFO("Profiler: %llu older events were overwritten; the trace holds the most recent %zu per thread",
+                     (unsigned long long)overwritten, g_events_per_thread.load(std::memory_order_relaxed));
+        }
+        return true;
+    }
+}
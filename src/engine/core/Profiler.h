@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Profiler
+{
+    constexpr size_t DEFAULT_EVENTS_PER_THREAD = 1 << 16;
+
+    // Zones are recorded into a ring owned by the calling thread, which
+    // keeps its most recent eventsPerThread events; nothing is recorded
+    // unless a capture is active. Names must be string literals (only the
+    // pointer is stored).
+    void beginCapture(size_t eventsPerThread = DEFAULT_EVENTS_PER_THREAD);
+    void endCapture();
+    bool isCapturing();
+
+    // Writes the last capture as Chrome trace JSON (chrome://tracing,
+    // ui.perfetto.dev). Call after endCapture().
+    bool writeChromeTrace(const char *path);
+
+    void setThreadName(const char *name);
+    void markFrame();
+
+    int64_t nowNs();
+    void recordZone(const char *name, int64_t startNs, int64_t endNs);
+
+    class Zone
+    {
+    public:
+        explicit Zone(const char *name) : name(name), startNs(nowNs()) {}
+        ~Zone() { recordZone(name, startNs, nowNs()); }
+
+        Zone(const Zone &) = delete;
+        Zone &operator=(const Zone &) = delete;
+
+    private:
+        const char *name;
+        int64_t startNs;
+    };
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_SCOPE(name) Profiler::Zone PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#define PROFILE_FRAME() Profiler::markFrame()
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
@@ -0,0 +1,38 @@
+#include "engine/core/Redraw.h"
+
+#include <atomic>
+
+namespace
+{
+    std::atomic<bool> g_requested{true};
+    std::atomic<int> g_continuous{0};
+}
+
+namespace Redraw
+{
+    void request()
+    {
+        g_requested.store(true, std::memory_order_release);
+    }
+
+    void beginContinuous()
+    {
+        g_continuous.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    void endContinuous()
+    {
+        g_continuous.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    bool pending()
+    {
+        return g_continuous.load(std::memory_order_acquire) > 0 || g_requested.load(std::memory_order_acquire);
+    }
+
+    bool consume()
+    {
+        bool requested = g_requested.exchange(false, std::memory_order_acq_rel);
+        return requested || g_continuous.load(std::memory_order_acquire) > 0;
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// Frame invalidation for on-demand rendering (EngineConfig::onDemandRedraw).
+// Changes that reach the recorded draw list (transforms, colours, camera,
+// added or removed elements) are detected by the renderer; anything else
+// that alters the picture, such as mesh contents rewritten in place or a
+// running animation, requests a redraw here. Safe to call from any thread.
+namespace Redraw
+{
+    void request();
+
+    // While any hold is active every frame renders.
+    void beginContinuous();
+    void endContinuous();
+
+    bool pending();
+    // Returns whether the next frame must render and clears the request.
+    bool consume();
+}
@@ -0,0 +1,129 @@
+#include "engine/core/ResolutionScaler.h"
+#include "engine/core/Metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Fractions of the budget.
+    constexpr double HIGH_RATIO = 0.95;
+    constexpr double LOW_RATIO = 0.75;
+    constexpr double AIM_RATIO = 0.85;
+
+    constexpr double SMOOTHING = 0.2;
+    constexpr uint32_t DROP_AFTER_FRAMES = 5;
+    constexpr uint32_t GROW_AFTER_FRAMES = 30;
+    // A drop soon after a grow means the grow was wrong; each one doubles
+    // the wait before growing again, up to this many frames.
+    constexpr uint32_t MAX_GROW_AFTER_FRAMES = 960;
+    // Frames at one scale before the grow wait starts shrinking back.
+    constexpr uint32_t STABLE_FRAMES = 600;
+    // Frames ignored after a change; GPU timings lag submission by a frame
+    // or two and the smoothed time needs a few more to catch up.
+    constexpr uint32_t SETTLE_FRAMES = 10;
+    constexpr float SCALE_STEP = 0.05f;
+}
+
+ResolutionScaler::ResolutionScaler(double budgetSeconds)
+    : budgetSeconds_(budgetSeconds > 0.0 ? budgetSeconds : 1.0 / 60.0), growAfterFrames_(GROW_AFTER_FRAMES)
+{
+}
+
+void ResolutionScaler::setBudget(double seconds)
+{
+    if (seconds > 0.0) {
+        budgetSeconds_ = seconds;
+    }
+}
+
+void ResolutionScaler::setRange(float minScale, float maxScale)
+{
+    maxScale_ = std::clamp(maxScale, SCALE_STEP, 1.0f);
+    minScale_ = std::clamp(minScale, SCALE_STEP, maxScale_);
+    scale_ = std::clamp(scale_, minScale_, maxScale_);
+}
+
+void ResolutionScaler::reset()
+{
+    scale_ = maxScale_;
+    smoothedSeconds_ = 0.0;
+    overFrames_ = 0;
+    underFrames_ = 0;
+    settleFrames_ = 0;
+    growAfterFrames_ = GROW_AFTER_FRAMES;
+    framesSinceChange_ = 0;
+    lastGrew_ = false;
+}
+
+void ResolutionScaler::apply(float scale)
+{
+    scale = std::clamp(scale, minScale_, maxScale_);
+    if (scale == scale_) {
+        return;
+    }
+    // Expected time at the new size, so the next decision doesn't wait for
+    // the average to walk there.
+    const double area = (double)scale / scale_;
+    smoothedSeconds_ *= area * area;
+    const bool grow = scale > scale_;
+    if (!grow && lastGrew_ && framesSinceChange_ < growAfterFrames_ + STABLE_FRAMES) {
+        growAfterFrames_ = std::min(growAfterFrames_ * 2, MAX_GROW_AFTER_FRAMES);
+    }
+    lastGrew_ = grow;
+    framesSinceChange_ = 0;
+    scale_ = scale;
+    overFrames_ = 0;
+    underFrames_ = 0;
+    settleFrames_ = SETTLE_FRAMES;
+    ++changes_;
+    METRIC_COUNT("render.resolution_changes", 1);
+}
+
+float ResolutionScaler::update(double frameSeconds)
+{
+    if (frameSeconds <= 0.0) {
+        return scale_;
+    }
+    smoothedSeconds_ = smoothedSeconds_ <= 0.0
+        ? frameSeconds
+        : smoothedSeconds_ + (frameSeconds - smoothedSeconds_) * SMOOTHING;
+
+    if (++framesSinceChange_ % STABLE_FRAMES == 0) {
+        growAfterFrames_ = std::max(growAfterFrames_ / 2, GROW_AFTER_FRAMES);
+    }
+    if (settleFrames_ > 0) {
+        --settleFrames_;
+        return scale_;
+    }
+
+    // A drop also needs the raw sample over the band, so the tail of a
+    // single spike in the average doesn't count.
+    const double ratio = smoothedSeconds_ / budgetSeconds_;
+    if (ratio > HIGH_RATIO && frameSeconds / budgetSeconds_ > HIGH_RATIO) {
+        ++overFrames_;
+        underFrames_ = 0;
+    } else if (ratio < LOW_RATIO) {
+        ++underFrames_;
+        overFrames_ = 0;
+    } else {
+        overFrames_ = 0;
+        underFrames_ = 0;
+    }
+
+    // Scales move on a grid of whole steps, at least one step at a time.
+    const float current = std::round(scale_ / SCALE_STEP);
+    const float ideal = std::floor(current * (float)std::sqrt(AIM_RATIO / ratio) + 0.001f);
+    if (overFrames_ >= DROP_AFTER_FRAMES && scale_ > minScale_) {
+        apply(std::min(ideal, current - 1.0f) * SCALE_STEP);
+    } else if (underFrames_ >= growAfterFrames_ && scale_ < maxScale_) {
+        const float grown = std::min(std::max(ideal, current + 1.0f) * SCALE_STEP, maxScale_);
+        const double predicted = ratio * ((double)grown / scale_) * ((double)grown / scale_);
+        if (predicted < HIGH_RATIO) {
+            apply(grown);
+        } else {
+            underFrames_ = 0;
+        }
+    }
+    return scale_;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+// Chooses a render scale (fraction of the drawable's width and height) from
+// measured frame times against a budget. Cost is taken to follow pixel
+// count, so a change aims the smoothed time at a point inside the band
+// between the low and high thresholds. To avoid oscillating, it only drops
+// after a few frames above the band, only grows after a long run below it
+// and when the predicted time stays under the band, moves in fixed steps,
+// and ignores samples for a while after each change so the new resolution
+// has time to show up in the measurements. A drop that undoes a recent grow
+// doubles the run needed before the next grow; the wait shrinks again once
+// the scale holds.
+class ResolutionScaler {
+public:
+    explicit ResolutionScaler(double budgetSeconds = 1.0 / 60.0);
+
+    void setBudget(double seconds);
+    double budget() const { return budgetSeconds_; }
+    // Clamped to (0, 1]; the current scale is pulled into the new range.
+    void setRange(float minScale, float maxScale);
+    float minScale() const { return minScale_; }
+    float maxScale() const { return maxScale_; }
+
+    // Feeds one measured frame time and returns the scale to render at.
+    float update(double frameSeconds);
+    float scale() const { return scale_; }
+    double smoothedSeconds() const { return smoothedSeconds_; }
+    uint64_t changes() const { return changes_; }
+    // Back to full scale with no history, e.g. after the drawable resizes.
+    void reset();
+
+private:
+    void apply(float scale);
+
+    double budgetSeconds_;
+    float minScale_ = 0.5f;
+    float maxScale_ = 1.0f;
+    float scale_ = 1.0f;
+    double smoothedSeconds_ = 0.0;
+    uint32_t overFrames_ = 0;
+    uint32_t underFrames_ = 0;
+    uint32_t settleFrames_ = 0;
+    uint32_t growAfterFrames_;
+    uint32_t framesSinceChange_ = 0;
+    bool lastGrew_ = false;
+    uint64_t changes_ = 0;
+};
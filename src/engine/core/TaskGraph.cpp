@@ -0,0 +1,189 @@
+#include "engine/core/TaskGraph.h"
+#include "engine/core/JobSystem.h"
+#include "engine/core/LogManager.h"
+#include "engine/core/Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <unordered_map>
+
+void TaskGraph::add(Task task)
+{
+    addBefore(std::string(), std::move(task));
+}
+
+void TaskGraph::addBefore(const std::string &anchor, Task task)
+{
+    if (executing_) {
+        std::lock_guard<std::mutex> lock(mainMutex_);
+        deferredEdits_.push_back([this, anchor, task = std::move(task)]() mutable { insert(anchor, std::move(task)); });
+        return;
+    }
+    insert(anchor, std::move(task));
+}
+
+void TaskGraph::remove(const std::string &name)
+{
+    if (executing_) {
+        std::lock_guard<std::mutex> lock(mainMutex_);
+        deferredEdits_.push_back([this, name] { erase(name); });
+        return;
+    }
+    erase(name);
+}
+
+void TaskGraph::insert(const std::string &anchor, Task task)
+{
+    auto node = std::make_unique<Node>();
+    node->task = std::move(task);
+    auto it = anchor.empty() ? nodes_.end() : std::find_if(nodes_.begin(), nodes_.end(), [&](const auto &existing) {
+        return existing->task.name == anchor;
+    });
+    nodes_.insert(it, std::move(node));
+    dirty_ = true;
+}
+
+void TaskGraph::erase(const std::string &name)
+{
+    auto it = std::find_if(nodes_.begin(), nodes_.end(), [&](const auto &node) { return node->task.name == name; });
+    if (it != nodes_.end()) {
+        nodes_.erase(it);
+        dirty_ = true;
+    }
+}
+
+void TaskGraph::compile()
+{
+    std::unordered_map<std::string, uint32_t> lastWriter;
+    std::unordered_map<std::string, std::vector<uint32_t>> readers;
+
+    auto addEdge = [this](uint32_t from, uint32_t to) {
+        auto &successors = nodes_[from]->successors;
+        if (from != to && std::find(successors.begin(), successors.end(), to) == successors.end()) {
+            successors.push_back(to);
+            ++nodes_[to]->dependencies;
+        }
+    };
+
+    for (auto &node : nodes_) {
+        node->successors.clear();
+        node->dependencies = 0;
+    }
+    for (uint32_t i = 0; i < (uint32_t)nodes_.size(); ++i) {
+        const Task &task = nodes_[i]->task;
+        for (const auto &resource : task.reads) {
+            auto writer = lastWriter.find(resource);
+            if (writer != lastWriter.end()) {
+                addEdge(writer->second, i);
+            }
+        }
+        for (const auto &resource : task.writes) {
+            auto writer = lastWriter.find(resource);
+            if (writer != lastWriter.end()) {
+                addEdge(writer->second, i);
+            }
+            for (uint32_t reader : readers[resource]) {
+                addEdge(reader, i);
+            }
+            readers[resource].clear();
+            lastWriter[resource] = i;
+        }
+        for (const auto &resource : task.reads) {
+            readers[resource].push_back(i);
+        }
+    }
+    dirty_ = false;
+}
+
+void TaskGraph::execute(JobSystem &jobs)
+{
+    if (dirty_) {
+        compile();
+    }
+    executing_ = true;
+    completed_.store(0, std::memory_order_relaxed);
+    for (auto &node : nodes_) {
+        node->remaining.store(node->dependencies, std::memory_order_relaxed);
+    }
+    for (uint32_t i = 0; i < (uint32_t)nodes_.size(); ++i) {
+        if (nodes_[i]->dependencies == 0) {
+            dispatch(i, jobs);
+        }
+    }
+
+    while (completed_.load(std::memory_order_acquire) < nodes_.size()) {
+        uint32_t index = UINT32_MAX;
+        {
+            std::lock_guard<std::mutex> lock(mainMutex_);
+            if (!mainReady_.empty()) {
+                index = mainReady_.back();
+                mainReady_.pop_back();
+            }
+        }
+        if (index != UINT32_MAX) {
+            runNode(index, jobs, false);
+        } else if (!jobs.runOne()) {
+            std::this_thread::yield();
+        }
+    }
+
+    executing_ = false;
+    std::vector<std::function<void()>> edits;
+    edits.swap(deferredEdits_);
+    for (auto &edit : edits) {
+        edit();
+    }
+}
+
+void TaskGraph::dispatch(uint32_t index, JobSystem &jobs)
+{
+    if (nodes_[index]->task.mainThread) {
+        std::lock_guard<std::mutex> lock(mainMutex_);
+        mainReady_.push_back(index);
+        return;
+    }
+    jobs.submit([this, index, &jobs] { runNode(index, jobs, true); });
+}
+
+void TaskGraph::runNode(uint32_t index, JobSystem &jobs, bool onWorker)
+{
+    Node &node = *nodes_[index];
+    int64_t start = Profiler::nowNs();
+    if (node.task.run) {
+        node.task.run();
+    }
+    node.lastDurationNs = Profiler::nowNs() - start;
+    node.ranOnWorker = onWorker;
+
+    for (uint32_t successor : node.successors) {
+        if (nodes_[successor]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            dispatch(successor, jobs);
+        }
+    }
+    completed_.fetch_add(1, std::memory_order_release);
+}
+
+bool TaskGraph::writeDot(const char *path) const
+{
+    FILE *file = std::fopen(path, "w");
+    if (!file) {
+        LOG_ERROR("TaskGraph: failed to open %s", path);
+        return false;
+    }
+    std::fputs("digraph frame {\n    rankdir=LR;\n    node [shape=box, fontname=\"Helvetica\"];\n", file);
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        const Node &node = *nodes_[i];
+        std::fprintf(file, "    n%zu [label=\"%s\\n%.3f ms%s\"%s];\n", i, node.task.name.c_str(),
+                     (double)node.lastDurationNs / 1e6, node.ranOnWorker ? " (worker)" : "",
+                     node.task.mainThread ? ", style=bold" : "");
+    }
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        for (uint32_t successor : nodes_[i]->successors) {
+            std::fprintf(file, "    n%zu -> n%u;\n", i, successor);
+        }
+    }
+    std::fputs("}\n", file);
+    std::fclose(file);
+    return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+// Per-frame DAG of tasks. Each task names the resources it reads and
+// writes; a task depends on the last earlier writer of anything it touches
+// and, when writing, on the earlier readers since that write. Tasks with no
+// path between them run concurrently on the job system. Main-thread tasks
+// only ever run on the thread that calls execute().
+class TaskGraph {
+public:
+    struct Task {
+        std::string name;
+        std::vector<std::string> reads;
+        std::vector<std::string> writes;
+        std::function<void()> run;
+        bool mainThread = false;
+    };
+
+    // Edits made from inside a running task apply after execute() returns.
+    void add(Task task);
+    // Inserts before `anchor` in declaration order, so the task is ordered
+    // ahead of it on shared resources. Appends if anchor is not found.
+    void addBefore(const std::string &anchor, Task task);
+    void remove(const std::string &name);
+    size_t size() const { return nodes_.size(); }
+
+    // Runs every task once and returns when all have finished.
+    void execute(JobSystem &jobs);
+
+    // Graphviz DOT with the last execution's time per task.
+    bool writeDot(const char *path) const;
+
+private:
+    struct Node {
+        Task task;
+        std::vector<uint32_t> successors;
+        uint32_t dependencies = 0;
+        std::atomic<uint32_t> remaining{0};
+        int64_t lastDurationNs = 0;
+        bool ranOnWorker = false;
+    };
+
+    void compile();
+    void dispatch(uint32_t index, JobSystem &jobs);
+    void runNode(uint32_t index, JobSystem &jobs, bool onWorker);
+    void insert(const std::string &anchor, Task task);
+    void erase(const std::string &name);
+
+    std::vector<std::unique_ptr<Node>> nodes_;
+    bool dirty_ = true;
+    bool executing_ = false;
+    std::vector<std::function<void()>> deferredEdits_;
+
+    std::mutex mainMutex_;
+    std::vector<uint32_t> mainReady_;
+    std::atomic<size_t> completed_{0};
+};
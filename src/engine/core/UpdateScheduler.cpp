@@ -0,0 +1,138 @@
+#include "engine/core/UpdateScheduler.h"
+#include "engine/core/Metrics.h"
+#include "engine/core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Deferred this many frames in a row, a tick runs regardless of budget.
+    constexpr uint32_t PROMOTE_AFTER_FRAMES = 8;
+    // Successive multiples of the golden ratio spread phases evenly over
+    // [0, 1) however many ticks there are.
+    constexpr double PHASE_STEP = 0.6180339887498949;
+}
+
+UpdateScheduler::TickId UpdateScheduler::add(const void *owner, double hz, Priority priority, Tick tick)
+{
+    Entry entry;
+    entry.id = nextId_++;
+    entry.owner = owner;
+    entry.period = hz > 0.0 ? 1.0 / hz : 0.0;
+    entry.nextDue = now_ + entry.period * std::fmod((double)phaseCounter_++ * PHASE_STEP, 1.0);
+    entry.lastRun = now_;
+    entry.priority = priority;
+    entry.tick = std::move(tick);
+
+    TickId id = entry.id;
+    if (updating_) {
+        added_.push_back(std::move(entry));
+    } else {
+        entries_.push_back(std::move(entry));
+    }
+    return id;
+}
+
+void UpdateScheduler::remove(TickId id)
+{
+    for (Entry &entry : entries_) {
+        if (entry.id == id) entry.removed = true;
+    }
+    for (Entry &entry : added_) {
+        if (entry.id == id) entry.removed = true;
+    }
+    needsSweep_ = true;
+    if (!updating_) {
+        sweep();
+    }
+}
+
+void UpdateScheduler::removeOwner(const void *owner)
+{
+    for (Entry &entry : entries_) {
+        if (entry.owner == owner) entry.removed = true;
+    }
+    for (Entry &entry : added_) {
+        if (entry.owner == owner) entry.removed = true;
+    }
+    needsSweep_ = true;
+    if (!updating_) {
+        sweep();
+    }
+}
+
+void UpdateScheduler::sweep()
+{
+    auto removed = [](const Entry &entry) { return entry.removed; };
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(), removed), entries_.end());
+    added_.erase(std::remove_if(added_.begin(), added_.end(), removed), added_.end());
+    needsSweep_ = false;
+}
+
+void UpdateScheduler::update(double now)
+{
+    now_ = now;
+    updating_ = true;
+
+    due_.clear();
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (!entries_[i].removed && entries_[i].nextDue <= now) {
+            due_.push_back(i);
+        }
+    }
+
+    auto urgent = [](const Entry &entry) {
+        return entry.priority == Priority::High || entry.deferredFrames >= PROMOTE_AFTER_FRAMES;
+    };
+    std::sort(due_.begin(), due_.end(), [&](size_t a, size_t b) {
+        const Entry &left = entries_[a];
+        const Entry &right = entries_[b];
+        bool leftUrgent = urgent(left);
+        bool rightUrgent = urgent(right);
+        if (leftUrgent != rightUrgent) return leftUrgent;
+        if (left.priority != right.priority) return left.priority > right.priority;
+        return left.nextDue < right.nextDue;
+    });
+
+    const int64_t startNs = Profiler::nowNs();
+    const int64_t budgetNs = (int64_t)(budgetSeconds_ * 1e9);
+    uint64_t ran = 0;
+    uint64_t deferred = 0;
+    for (size_t index : due_) {
+        Entry &entry = entries_[index];
+        if (entry.removed) {
+            continue;
+        }
+        const bool shed = shedding_ && entry.priority == Priority::Low;
+        if (!urgent(entry) && (shed || (budgetNs > 0 && Profiler::nowNs() - startNs >= budgetNs))) {
+            ++entry.deferredFrames;
+            ++deferred;
+            continue;
+        }
+
+        double elapsed = now - entry.lastRun;
+        entry.lastRun = now;
+        entry.deferredFrames = 0;
+        if (entry.period > 0.0) {
+            // Skip whole missed periods but keep the phase.
+            entry.nextDue += (std::floor((now - entry.nextDue) / entry.period) + 1.0) * entry.period;
+        }
+        entry.tick(elapsed);
+        ++ran;
+    }
+
+    updating_ = false;
+    if (!added_.empty()) {
+        for (Entry &entry : added_) {
+            entries_.push_back(std::move(entry));
+        }
+        added_.clear();
+    }
+    if (needsSweep_) {
+        sweep();
+    }
+
+    METRIC_COUNT("updates.ticks", ran);
+    METRIC_COUNT("updates.deferred", deferred);
+}
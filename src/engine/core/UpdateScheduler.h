@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Runs element ticks at their own rates instead of every frame. Ticks that
+// share a rate are given spread-out phases so they don't all land on the
+// same frame. With a budget set, once a frame's ticks have used it up the
+// remaining Normal and Low ticks wait for the next frame; High ticks always
+// run, and a tick deferred for several frames in a row is promoted so low
+// priority work can't starve.
+class UpdateScheduler {
+public:
+    enum class Priority : uint8_t {
+        Low,
+        Normal,
+        High
+    };
+
+    using TickId = uint64_t;
+    // Receives the seconds since the tick last ran, or for its first run
+    // since it was added (as of the scheduler's latest update()).
+    using Tick = std::function<void(double elapsedSeconds)>;
+
+    // Adds ticks on behalf of one owner so they can be removed together.
+    class Registrar {
+    public:
+        Registrar(UpdateScheduler &scheduler, const void *owner, UpdateScheduler *workerScheduler = nullptr)
+            : scheduler_(scheduler), workerScheduler_(workerScheduler), owner_(owner) {}
+
+        TickId add(double hz, Priority priority, Tick tick) {
+            return scheduler_.add(owner_, hz, priority, std::move(tick));
+        }
+
+        // For ticks that only touch their owner's own state and read shared
+        // state that is safe off the main thread (InputState, Metrics,
+        // EngineIO reads). With a worker scheduler they run on a job system
+        // worker, alongside the main-thread ticks of other owners; without
+        // one this is add().
+        TickId addOffMain(double hz, Priority priority, Tick tick) {
+            return (workerScheduler_ ? *workerScheduler_ : scheduler_).add(owner_, hz, priority, std::move(tick));
+        }
+
+    private:
+        UpdateScheduler &scheduler_;
+        UpdateScheduler *workerScheduler_;
+        const void *owner_;
+    };
+
+    // hz <= 0 ticks every frame. Changes made from inside a tick apply
+    // after the current update().
+    TickId add(const void *owner, double hz, Priority priority, Tick tick);
+    void remove(TickId id);
+    void removeOwner(const void *owner);
+    Registrar ownedBy(const void *owner) { return Registrar(*this, owner); }
+
+    // Seconds of tick time per frame; 0 disables the budget.
+    void setBudget(double seconds) { budgetSeconds_ = seconds; }
+    double budget() const { return budgetSeconds_; }
+    // While set (e.g. the frame is over budget), Low ticks are deferred
+    // regardless of the budget, still subject to promotion.
+    void setShedding(bool shedding) { shedding_ = shedding; }
+
+    void update(double now);
+    size_t size() const { return entries_.size() + added_.size(); }
+
+private:
+    struct Entry {
+        TickId id = 0;
+        const void *owner = nullptr;
+        double period = 0.0;
+        double nextDue = 0.0;
+        double lastRun = 0.0;
+        Priority priority = Priority::Normal;
+        uint32_t deferredFrames = 0;
+        bool removed = false;
+        Tick tick;
+    };
+
+    void sweep();
+
+    std::vector<Entry> entries_;
+    std::vector<Entry> added_;
+    std::vector<size_t> due_;
+    TickId nextId_ = 1;
+    uint64_t phaseCounter_ = 0;
+    double budgetSeconds_ = 0.0;
+    double now_ = 0.0;
+    bool updating_ = false;
+    bool shedding_ = false;
+    bool needsSweep_ = false;
+};
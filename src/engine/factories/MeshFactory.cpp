@@ -1,5 +1,13 @@
 #include "engine/factories/MeshFactory.h"
 #include "engine/core/LogManager.h"
+#include "engine/core/Metrics.h"
+
+MTL::Buffer *MeshFactory::newBuffer(MTL::Device *device, size_t bytes)
+{
+    METRIC_COUNT("gpu.buffer_allocs", 1);
+    METRIC_COUNT("gpu.buffer_bytes", bytes);
+    return device->newBuffer(bytes, MTL::ResourceStorageModeShared);
+}
 
 MTL::Buffer *MeshFactory::buildTriangle(MTL::Device *device)
 {
@@ -10,7 +18,7 @@ MTL::Buffer *MeshFactory::buildTriangle(MTL::Device *device)
         {{0.5, -0.5, 0.0},  {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f}},
         {{0.0, 0.5, 0.0},   {1.0f, 1.0f, 1.0f}, {0.5f, 1.0f}}};
 
-    MTL::Buffer *buffer = device->newBuffer(3 * sizeof(Vertex), MTL::ResourceStorageModeShared);
+    MTL::Buffer *buffer = MeshFactory::newBuffer(device, 3 * sizeof(Vertex));
 
     memcpy(buffer->contents(), verticies, 3 * sizeof(Vertex));
 
@@ -32,10 +40,10 @@ Mesh MeshFactory::buildQuad(MTL::Device *device)
         0, 1, 2,
         2, 3, 0};
 
-    mesh.vertexBuffer = device->newBuffer(4 * sizeof(Vertex), MTL::ResourceStorageModeShared);
+    mesh.vertexBuffer = MeshFactory::newBuffer(device, 4 * sizeof(Vertex));
     memcpy(mesh.vertexBuffer->contents(), verticies, 4 * sizeof(Vertex));
 
-    mesh.indexBuffer = device->newBuffer(6 * sizeof(ushort), MTL::ResourceStorageModeShared);
+    mesh.indexBuffer = MeshFactory::newBuffer(device, 6 * sizeof(ushort));
     memcpy(mesh.indexBuffer->contents(), indices, 6 * sizeof(ushort));
 
     mesh.vertexCount = 4;
@@ -103,10 +111,10 @@ Mesh MeshFactory::buildCube(MTL::Device *device)
         
         3, 2, 6, 6, 7, 3};
 
-    mesh.vertexBuffer = device->newBuffer(8 * sizeof(Vertex), MTL::ResourceStorageModeShared);
+    mesh.vertexBuffer = MeshFactory::newBuffer(device, 8 * sizeof(Vertex));
     memcpy(mesh.vertexBuffer->contents(), vertices, 8 * sizeof(Vertex));
 
-    mesh.indexBuffer = device->newBuffer(36 * sizeof(ushort), MTL::ResourceStorageModeShared);
+    mesh.indexBuffer = MeshFactory::newBuffer(device, 36 * sizeof(ushort));
     memcpy(mesh.indexBuffer->contents(), indices, 36 * sizeof(ushort));
 
     
@@ -161,10 +169,10 @@ Mesh MeshFactory::buildScreenQuad(MTL::Device *device, float left, float top, fl
 
     ushort indices[6] = {0, 1, 2, 2, 3, 0};
 
-    mesh.vertexBuffer = device->newBuffer(4 * sizeof(Vertex), MTL::ResourceStorageModeShared);
+    mesh.vertexBuffer = MeshFactory::newBuffer(device, 4 * sizeof(Vertex));
     memcpy(mesh.vertexBuffer->contents(), verticies, 4 * sizeof(Vertex));
 
-    mesh.indexBuffer = device->newBuffer(6 * sizeof(ushort), MTL::ResourceStorageModeShared);
+    mesh.indexBuffer = MeshFactory::newBuffer(device, 6 * sizeof(ushort));
     memcpy(mesh.indexBuffer->contents(), indices, 6 * sizeof(ushort));
 
     
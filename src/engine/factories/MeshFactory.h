@@ -4,6 +4,8 @@
 
 namespace MeshFactory
 {
+    // Shared-storage buffer; counted in the gpu.buffer_* metrics.
+    MTL::Buffer *newBuffer(MTL::Device *device, size_t bytes);
     MTL::Buffer *buildTriangle(MTL::Device *device);
     Mesh buildQuad(MTL::Device *device);
     Mesh buildCube(MTL::Device *device);
@@ -1,6 +1,7 @@
 #include "engine/factories/PipelineFactory.h"
 #include "engine/utils/FileReader.h"
 #include "engine/core/LogManager.h"
+#include "engine/core/Metrics.h"
 
 PipelineFactory::PipelineFactory(MTL::Device* device):
 device(device->retain()) {}
@@ -37,6 +38,7 @@ void PipelineFactory::set_alpha_blending(bool enable) {
 }
 
 MTL::RenderPipelineState* PipelineFactory::build() {
+    METRIC_COUNT("pipeline.builds", 1);
     std::string name = std::string("data/Shaders/") + fileName + ".metal";
     std::string reader = ReadFile(name);
     NS::String *shaderSource = NS::String::string(reader.c_str(), NS::StringEncoding::UTF8StringEncoding);
@@ -1,21 +1,28 @@
 #include "engine/systems/MeshRenderer.h"
+#include "engine/components/engine/Shader.h"
 #include "engine/core/LogManager.h"
+#include "engine/core/Metrics.h"
+#include "engine/core/Profiler.h"
+#include "engine/core/Redraw.h"
 #include "engine/utils/Math.h"
 #include "engine/components/renderables/core/UIElement.h"
 #include "engine/systems/input/InputState.h"
 
-#include <chrono>
+#include <algorithm>
 #include <cmath>
 
-MeshRenderer::MeshRenderer(MTL::Device *device, CA::MetalLayer *metalLayer)
+MeshRenderer::MeshRenderer(MTL::Device *device, CA::MetalLayer *metalLayer, unsigned latencyFrames)
     : device(device->retain()),
-      metalLayer(metalLayer->retain()),
+      metalLayer(metalLayer ? metalLayer->retain() : nullptr),
       drawableArea(nullptr),
       commandQueue(device->newCommandQueue()->retain()),
       depthState(nullptr),
       depthStateUI(nullptr),
       depthTexture(nullptr),
-      clearColor(MTL::ClearColor(0.1, 0.1, 0.1, 1.0))
+      clearColor(MTL::ClearColor(0.1, 0.1, 0.1, 1.0)),
+      lastClearColor(MTL::ClearColor(0.0, 0.0, 0.0, 0.0)),
+      gpuFrameSeconds(std::make_shared<std::atomic<double>>(0.0)),
+      latencyFrames(std::min(latencyFrames, 2u))
 {
     LOG_CONSTRUCT("MeshRenderer");
     orthoLeft = -1.0f;
@@ -38,14 +45,30 @@ MeshRenderer::MeshRenderer(MTL::Device *device, CA::MetalLayer *metalLayer)
     dsUIDesc->setDepthWriteEnabled(false);
     depthStateUI = device->newDepthStencilState(dsUIDesc);
     dsUIDesc->release();
+
+    if (this->latencyFrames > 0 && metalLayer)
+    {
+        renderThread = std::thread(&MeshRenderer::renderLoop, this);
+    }
 }
 
 MeshRenderer::~MeshRenderer()
 {
     LOG_DESTROY("MeshRenderer");
+    if (renderThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(frameMutex);
+            stopping = true;
+        }
+        frameQueued.notify_one();
+        renderThread.join();
+    }
+    freeFrames.clear();
     renderables.clear();
     commandQueue->release();
-    metalLayer->release();
+    if (metalLayer)
+        metalLayer->release();
     device->release();
     if (depthState)
         depthState->release();
@@ -53,6 +76,10 @@ MeshRenderer::~MeshRenderer()
         depthStateUI->release();
     if (depthTexture)
         depthTexture->release();
+    if (sceneTexture)
+        sceneTexture->release();
+    if (upscaleSampler)
+        upscaleSampler->release();
 }
 
 void MeshRenderer::addRenderable(const std::shared_ptr<Renderable> &r)
@@ -65,6 +92,52 @@ void MeshRenderer::clearRenderables()
     renderables.clear();
 }
 
+void MeshRenderer::setDynamicResolution(bool enabled, double budgetSeconds, float minScale)
+{
+    // Built here rather than on the first scaled frame, so the render
+    // thread never compiles a pipeline mid-frame. The render thread only
+    // reads these once a setting with enabled set has reached it.
+    if (enabled && !upscaleShader)
+    {
+        upscaleShader = std::make_unique<Shader>(device, "Upscale", "vertexUpscale", "fragmentUpscale");
+        MTL::SamplerDescriptor *samplerDesc = MTL::SamplerDescriptor::alloc()->init();
+        samplerDesc->setMinFilter(MTL::SamplerMinMagFilterLinear);
+        samplerDesc->setMagFilter(MTL::SamplerMinMagFilterLinear);
+        samplerDesc->setSAddressMode(MTL::SamplerAddressModeClampToEdge);
+        samplerDesc->setTAddressMode(MTL::SamplerAddressModeClampToEdge);
+        upscaleSampler = device->newSamplerState(samplerDesc);
+        samplerDesc->release();
+    }
+    if (enabled && (!upscaleShader->pipeline() || !upscaleSampler))
+    {
+        LOG_ERROR("MeshRenderer: upscale pipeline failed to build - rendering at native resolution");
+        enabled = false;
+    }
+
+    std::lock_guard<std::mutex> lock(frameMutex);
+    pendingResolution = {enabled, budgetSeconds, minScale};
+    resolutionPending = true;
+}
+
+void MeshRenderer::applyPendingResolution()
+{
+    ResolutionSettings settings;
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        if (!resolutionPending)
+        {
+            return;
+        }
+        settings = pendingResolution;
+        resolutionPending = false;
+    }
+    dynamicResolution = settings.enabled;
+    resolutionScaler.setBudget(settings.budgetSeconds);
+    resolutionScaler.setRange(settings.minScale, 1.0f);
+    resolutionScaler.reset();
+    currentScale.store(1.0f, std::memory_order_relaxed);
+}
+
 void MeshRenderer::setOrthoParams(float left, float right, float bottom, float top, float near, float far)
 {
     orthoLeft = left;
@@ -74,30 +147,169 @@ void MeshRenderer::setOrthoParams(float left, float right, float bottom, float t
     orthoNear = near;
     orthoFar = far;
 }
-void MeshRenderer::draw(const CameraMatrices &camera, const std::vector<std::shared_ptr<UIContainer>> &uiElements, const std::vector<std::shared_ptr<WorldContainer>> &worldElements)
+bool MeshRenderer::draw(const CameraMatrices &camera, const std::vector<std::shared_ptr<UIContainer>> &uiElements, const std::vector<std::shared_ptr<WorldContainer>> &worldElements)
 {
-    NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+    PROFILE_SCOPE("MeshRenderer::draw");
+    recordWorld(camera, worldElements);
+    recordUI(uiElements);
+    return submit();
+}
+
+void MeshRenderer::recordWorld(const CameraMatrices &camera, const std::vector<std::shared_ptr<WorldContainer>> &worldElements)
+{
+    DrawList &drawList = worldDraws;
+    drawList.setDepthMode(DepthMode::World);
+
+    const simd::float4x4 worldProjection = camera.projection;
+    const simd::float4x4 worldView = camera.view;
+    const simd::float4x4 ortho = MetalMath::orthographicProjection(orthoLeft, orthoRight, orthoBottom, orthoTop, orthoNear, orthoFar);
+    const simd::float4x4 identity = MetalMath::identity();
+
+    {
+        PROFILE_SCOPE("RecordScene");
+        for (const auto &renderable : renderables)
+        {
+            if (!renderable)
+            {
+                continue;
+            }
+
+            if (renderable->isScreenSpace())
+            {
+                drawList.setDepthMode(DepthMode::Overlay);
+                renderable->draw(&drawList, ortho, identity);
+                drawList.setDepthMode(DepthMode::World);
+            }
+            else
+            {
+                renderable->draw(&drawList, worldProjection, worldView);
+            }
+        }
+    }
+
+    {
+        PROFILE_SCOPE("RecordWorld");
+        for (const auto &worldElement : worldElements)
+        {
+            if (worldElement)
+            {
+                worldElement->render(&drawList, worldProjection, worldView);
+            }
+        }
+    }
+}
+
+void MeshRenderer::recordUI(const std::vector<std::shared_ptr<UIContainer>> &uiElements)
+{
+    PROFILE_SCOPE("RecordUI");
+    uiDraws.setDepthMode(DepthMode::Overlay);
+    drawUI(uiElements, &uiDraws);
+}
+
+bool MeshRenderer::submit()
+{
+    blockedSeconds = 0.0;
+
+    std::unique_ptr<Frame> frame;
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        if (!freeFrames.empty())
+        {
+            frame = std::move(freeFrames.back());
+            freeFrames.pop_back();
+        }
+    }
+    if (!frame)
+    {
+        frame = std::make_unique<Frame>();
+    }
+
+    frame->drawList.append(worldDraws);
+    frame->drawList.append(uiDraws);
+    frame->clearColor = clearColor;
+
+    if (skipUnchanged)
+    {
+        const uint64_t signature = frame->drawList.signature();
+        const bool unchanged = signature == lastSignature &&
+                               frame->clearColor.red == lastClearColor.red &&
+                               frame->clearColor.green == lastClearColor.green &&
+                               frame->clearColor.blue == lastClearColor.blue &&
+                               frame->clearColor.alpha == lastClearColor.alpha;
+        lastSignature = signature;
+        lastClearColor = frame->clearColor;
+        const bool requested = Redraw::consume();
+        if (unchanged && !requested)
+        {
+            METRIC_COUNT("render.frames_skipped", 1);
+            recycle(std::move(frame));
+            return false;
+        }
+    }
+
+    if (!renderThread.joinable())
+    {
+        blockedSeconds = encode(*frame);
+        recycle(std::move(frame));
+        return metalLayer != nullptr;
+    }
+
+    std::unique_lock<std::mutex> lock(frameMutex);
+    {
+        PROFILE_SCOPE("WaitForRenderThread");
+        const int64_t waitStartNs = Profiler::nowNs();
+        frameTaken.wait(lock, [this] { return queuedFrames.size() < latencyFrames; });
+        blockedSeconds = (double)(Profiler::nowNs() - waitStartNs) * 1e-9;
+    }
+    queuedFrames.push_back(std::move(frame));
+    lock.unlock();
+    frameQueued.notify_one();
+    return true;
+}
+
+void MeshRenderer::recycle(std::unique_ptr<Frame> frame)
+{
+    frame->drawList.clear();
+    std::lock_guard<std::mutex> lock(frameMutex);
+    freeFrames.push_back(std::move(frame));
+}
+
+void MeshRenderer::flush()
+{
+    if (!renderThread.joinable())
+    {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(frameMutex);
+    frameTaken.wait(lock, [this] { return queuedFrames.empty() && !encoding; });
+}
 
-    auto frameStart = std::chrono::high_resolution_clock::now();
+double MeshRenderer::encode(Frame &frame)
+{
+    PROFILE_SCOPE("MeshRenderer::encode");
+    applyPendingResolution();
+    if (!metalLayer)
+    {
+        return 0.0;
+    }
+    NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
 
     MTL::CommandBuffer *commandBuffer = commandQueue->commandBuffer();
     MTL::RenderPassDescriptor *renderPass = MTL::RenderPassDescriptor::alloc()->init();
 
-    drawableArea = metalLayer->nextDrawable();
+    const int64_t acquireStartNs = Profiler::nowNs();
+    {
+        PROFILE_SCOPE("AcquireDrawable");
+        drawableArea = metalLayer->nextDrawable();
+    }
+    const double acquireSeconds = (double)(Profiler::nowNs() - acquireStartNs) * 1e-9;
     if (!drawableArea)
     {
-        LOG_ERROR("MeshRenderer::draw: metalLayer->nextDrawable() returned null - skipping frame");
+        LOG_ERROR("MeshRenderer::encode: metalLayer->nextDrawable() returned null - skipping frame");
         pool->release();
         renderPass->release();
-        return;
+        return acquireSeconds;
     }
-    auto afterDrawable = std::chrono::high_resolution_clock::now();
-    MTL::RenderPassColorAttachmentDescriptor *colorAttachment = renderPass->colorAttachments()->object(0);
-    colorAttachment->setTexture(drawableArea->texture());
-    colorAttachment->setLoadAction(MTL::LoadActionClear);
-    colorAttachment->setClearColor(clearColor);
-    colorAttachment->setStoreAction(MTL::StoreActionStore);
-
     
     uint32_t drawableWidth = drawableArea->texture()->width();
     uint32_t drawableHeight = drawableArea->texture()->height();
@@ -106,9 +318,9 @@ void MeshRenderer::draw(const CameraMatrices &camera, const std::vector<std::sha
         needNewDepth = true;
     else if (depthTexture->width() != drawableWidth || depthTexture->height() != drawableHeight)
         needNewDepth = true;
-    std::chrono::high_resolution_clock::time_point afterDepthAlloc = afterDrawable;
     if (needNewDepth)
     {
+        PROFILE_SCOPE("DepthAlloc");
         if (depthTexture)
         {
             depthTexture->release();
@@ -122,9 +334,25 @@ void MeshRenderer::draw(const CameraMatrices &camera, const std::vector<std::sha
         desc->setUsage(MTL::TextureUsageRenderTarget);
         desc->setStorageMode(MTL::StorageModePrivate);
         depthTexture = device->newTexture(desc);
-        afterDepthAlloc = std::chrono::high_resolution_clock::now();
     }
 
+    float scale = 1.0f;
+    if (dynamicResolution)
+    {
+        scale = resolutionScaler.update(gpuFrameSeconds->exchange(0.0));
+        currentScale.store(scale, std::memory_order_relaxed);
+        METRIC_GAUGE("render.resolution_scale", scale);
+    }
+    // The world pass at reduced size; the drawable pass then upscales it
+    // and draws only the overlay on top.
+    const bool scaled = scale < 1.0f && encodeScaledScene(commandBuffer, frame, scale, drawableWidth, drawableHeight);
+
+    MTL::RenderPassColorAttachmentDescriptor *colorAttachment = renderPass->colorAttachments()->object(0);
+    colorAttachment->setTexture(drawableArea->texture());
+    colorAttachment->setLoadAction(scaled ? MTL::LoadActionDontCare : MTL::LoadActionClear);
+    colorAttachment->setClearColor(frame.clearColor);
+    colorAttachment->setStoreAction(MTL::StoreActionStore);
+
     MTL::RenderPassDepthAttachmentDescriptor *depthAttachment = renderPass->depthAttachment();
     depthAttachment->setTexture(depthTexture);
     depthAttachment->setLoadAction(MTL::LoadActionClear);
@@ -132,104 +360,162 @@ void MeshRenderer::draw(const CameraMatrices &camera, const std::vector<std::sha
     depthAttachment->setStoreAction(MTL::StoreActionDontCare);
 
     MTL::RenderCommandEncoder *encoder = commandBuffer->renderCommandEncoder(renderPass);
-    auto afterEncoder = std::chrono::high_resolution_clock::now();
 
-    if (depthState)
+    if (scaled)
     {
-        encoder->setDepthStencilState(depthState);
+        encodeUpscale(encoder, scale, drawableWidth, drawableHeight);
     }
 
-    const simd::float4x4 worldProjection = camera.projection;
-    const simd::float4x4 worldView = camera.view;
-    const simd::float4x4 ortho = MetalMath::orthographicProjection(orthoLeft, orthoRight, orthoBottom, orthoTop, orthoNear, orthoFar);
-    const simd::float4x4 identity = MetalMath::identity();
-
-    auto beforeScene = std::chrono::high_resolution_clock::now();
-    for (const auto &renderable : renderables)
     {
-        if (!renderable)
-        {
-            continue;
-        }
-
-        if (renderable->isScreenSpace())
-        {
-            if (depthStateUI)
-            {
-                encoder->setDepthStencilState(depthStateUI);
-            }
-            renderable->draw(encoder, ortho, identity);
-            if (depthState)
-            {
-                encoder->setDepthStencilState(depthState);
-            }
-        }
+        PROFILE_SCOPE("EncodeDrawList");
+        if (scaled)
+            frame.drawList.encode(encoder, depthState, depthStateUI, DepthMode::Overlay);
         else
-        {
-            renderable->draw(encoder, worldProjection, worldView);
-        }
+            frame.drawList.encode(encoder, depthState, depthStateUI);
     }
-    auto afterScene = std::chrono::high_resolution_clock::now();
 
-    for (const auto &worldElement : worldElements)
     {
-        if (worldElement)
+        PROFILE_SCOPE("Submit");
+        encoder->endEncoding();
+        if (dynamicResolution)
+        {
+            commandBuffer->addCompletedHandler([gpuSeconds = gpuFrameSeconds](MTL::CommandBuffer *buffer) {
+                gpuSeconds->store(buffer->GPUEndTime() - buffer->GPUStartTime());
+            });
+        }
+        if (presentHandler)
         {
-            worldElement->render(encoder, worldProjection, worldView);
+            drawableArea->addPresentedHandler([handler = presentHandler](MTL::Drawable *drawable) {
+                handler(drawable->presentedTime());
+            });
         }
+        commandBuffer->presentDrawable(drawableArea);
+        commandBuffer->commit();
     }
-    auto afterWorld = std::chrono::high_resolution_clock::now();
 
-    auto beforeUI = std::chrono::high_resolution_clock::now();
+    renderPass->release();
+    pool->release();
+    return acquireSeconds;
+}
 
-    
-    if (depthStateUI) {
-        encoder->setDepthStencilState(depthStateUI);
+bool MeshRenderer::encodeScaledScene(MTL::CommandBuffer *commandBuffer, Frame &frame, float scale,
+                                     uint32_t width, uint32_t height)
+{
+    PROFILE_SCOPE("EncodeScaledScene");
+    if (!upscaleShader || !upscaleShader->pipeline() || !upscaleSampler)
+    {
+        return false;
     }
-    
-    for (const auto &uiElement : uiElements)
+
+    // Full drawable size so the scale can change without reallocating;
+    // only the top-left corner is rendered.
+    if (!sceneTexture || sceneTexture->width() != width || sceneTexture->height() != height)
     {
-        if (uiElement)
+        PROFILE_SCOPE("SceneTargetAlloc");
+        if (sceneTexture)
         {
-            uiElement->render(encoder);
+            sceneTexture->release();
+        }
+        MTL::TextureDescriptor *desc = MTL::TextureDescriptor::texture2DDescriptor(
+            MTL::PixelFormat::PixelFormatBGRA8Unorm,
+            width,
+            height,
+            false);
+        desc->setUsage(MTL::TextureUsageRenderTarget | MTL::TextureUsageShaderRead);
+        desc->setStorageMode(MTL::StorageModePrivate);
+        sceneTexture = device->newTexture(desc);
+        if (!sceneTexture)
+        {
+            LOG_ERROR("MeshRenderer: failed to allocate %ux%u scene target", width, height);
+            return false;
         }
     }
-    auto afterUI = std::chrono::high_resolution_clock::now();
 
+    MTL::RenderPassDescriptor *scenePass = MTL::RenderPassDescriptor::alloc()->init();
+    MTL::RenderPassColorAttachmentDescriptor *colorAttachment = scenePass->colorAttachments()->object(0);
+    colorAttachment->setTexture(sceneTexture);
+    colorAttachment->setLoadAction(MTL::LoadActionClear);
+    colorAttachment->setClearColor(frame.clearColor);
+    colorAttachment->setStoreAction(MTL::StoreActionStore);
+
+    // The drawable pass clears depth again, so the two passes share it.
+    MTL::RenderPassDepthAttachmentDescriptor *depthAttachment = scenePass->depthAttachment();
+    depthAttachment->setTexture(depthTexture);
+    depthAttachment->setLoadAction(MTL::LoadActionClear);
+    depthAttachment->setClearDepth(1.0f);
+    depthAttachment->setStoreAction(MTL::StoreActionDontCare);
+
+    MTL::RenderCommandEncoder *encoder = commandBuffer->renderCommandEncoder(scenePass);
+    const uint32_t scaledWidth = std::max(1u, (uint32_t)std::lround(width * scale));
+    const uint32_t scaledHeight = std::max(1u, (uint32_t)std::lround(height * scale));
+    encoder->setViewport(MTL::Viewport{0.0, 0.0, (double)scaledWidth, (double)scaledHeight, 0.0, 1.0});
+    frame.drawList.encode(encoder, depthState, depthStateUI, DepthMode::World);
     encoder->endEncoding();
-    auto afterEndEncoding = std::chrono::high_resolution_clock::now();
-    commandBuffer->presentDrawable(drawableArea);
-    auto afterPresent = std::chrono::high_resolution_clock::now();
-    commandBuffer->commit();
-    auto afterCommit = std::chrono::high_resolution_clock::now();
+    scenePass->release();
+    return true;
+}
 
-    
-    auto frameEnd = std::chrono::high_resolution_clock::now();
-    using ms = std::chrono::duration<double, std::milli>;
-    double t_total = ms(frameEnd - frameStart).count();
-    double t_acquire = ms(afterDrawable - frameStart).count();
-    double t_depth = (needNewDepth ? ms(afterDepthAlloc - afterDrawable).count() : 0.0);
-    double t_encoder = ms(afterEncoder - afterDrawable).count();
-    double t_scene = ms(afterScene - beforeScene).count();
-    double t_ui = ms(afterUI - beforeUI).count();
-    double t_end = ms(afterEndEncoding - afterUI).count();
-    double t_present = ms(afterPresent - afterEndEncoding).count();
-    double t_commit = ms(afterCommit - afterPresent).count();
-
-    LOG_DEBUG("Frame timings ms: total=%.2f acquire=%.2f depthAlloc=%.2f encoderSetup=%.2f scene=%.2f ui=%.2f endEncode=%.2f present=%.2f commit=%.2f",
-              t_total, t_acquire, t_depth, t_encoder, t_scene, t_ui, t_end, t_present, t_commit);
+void MeshRenderer::encodeUpscale(MTL::RenderCommandEncoder *encoder, float scale, uint32_t width, uint32_t height)
+{
+    struct UpscaleParams {
+        simd::float2 uvScale;
+        simd::float2 uvMax;
+    };
+    const float scaledWidth = (float)std::max(1u, (uint32_t)std::lround(width * scale));
+    const float scaledHeight = (float)std::max(1u, (uint32_t)std::lround(height * scale));
+    const UpscaleParams params{
+        {scaledWidth / width, scaledHeight / height},
+        {(scaledWidth - 0.5f) / width, (scaledHeight - 0.5f) / height}};
+
+    encoder->setRenderPipelineState(upscaleShader->pipeline());
+    encoder->setDepthStencilState(depthStateUI);
+    encoder->setVertexBytes(&params, sizeof(params), 0);
+    encoder->setFragmentBytes(&params, sizeof(params), 0);
+    encoder->setFragmentTexture(sceneTexture, 0);
+    encoder->setFragmentSamplerState(upscaleSampler, 0);
+    encoder->drawPrimitives(MTL::PrimitiveTypeTriangle, NS::UInteger(0), NS::UInteger(3));
+    // Overlay draws without a texture of their own must not see the scene.
+    encoder->setFragmentTexture(nullptr, 0);
+}
 
-    renderPass->release();
-    pool->release();
+void MeshRenderer::renderLoop()
+{
+    PROFILE_THREAD("Render");
+    while (true)
+    {
+        std::unique_ptr<Frame> frame;
+        {
+            std::unique_lock<std::mutex> lock(frameMutex);
+            frameQueued.wait(lock, [this] { return stopping || !queuedFrames.empty(); });
+            if (queuedFrames.empty())
+            {
+                return;
+            }
+            frame = std::move(queuedFrames.front());
+            queuedFrames.pop_front();
+            encoding = true;
+        }
+        frameTaken.notify_all();
+
+        encode(*frame);
+        frame->drawList.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(frameMutex);
+            freeFrames.push_back(std::move(frame));
+            encoding = false;
+        }
+        frameTaken.notify_all();
+    }
 }
 
-void MeshRenderer::drawUI(const std::vector<std::shared_ptr<UIContainer>> &uiElements, MTL::RenderCommandEncoder *encoder)
+void MeshRenderer::drawUI(const std::vector<std::shared_ptr<UIContainer>> &uiElements, DrawList *drawList)
 {
     for (const auto &uiElement : uiElements)
     {
         if (uiElement)
         {
-            uiElement->render(encoder);
+            uiElement->render(drawList);
         }
     }
 }
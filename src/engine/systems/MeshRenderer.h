@@ -2,21 +2,56 @@
 
 #include "engine/config.h"
 #include "engine/core/Camera.h"
+#include "engine/core/ResolutionScaler.h"
 #include "engine/components/engine/Renderable.h"
 #include "engine/components/renderables/core/UIContainer.h"
 #include "engine/components/renderables/core/WorldContainer.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
+class Shader;
+
 class MeshRenderer {
 public:
-    MeshRenderer(MTL::Device *device, CA::MetalLayer *metalLayer);
+    // draw() records the frame into a draw list on the calling thread. With
+    // latencyFrames 0 it is encoded and submitted right away; with 1 or 2 it
+    // is queued for a render thread and draw() only blocks once that many
+    // frames are waiting, so the caller can simulate ahead of encoding.
+    // Without a layer (headless) frames are recorded and then discarded.
+    MeshRenderer(MTL::Device *device, CA::MetalLayer *metalLayer, unsigned latencyFrames = 0);
     ~MeshRenderer();
 
     void addRenderable(const std::shared_ptr<Renderable> &r);
     void clearRenderables();
-    void draw(const CameraMatrices &camera, const std::vector<std::shared_ptr<UIContainer>> &uiElements, const std::vector<std::shared_ptr<WorldContainer>> &worldElements);
-    void drawUI(const std::vector<std::shared_ptr<UIContainer>> &uiElements, MTL::RenderCommandEncoder *encoder);
+    // Returns false when the frame was not submitted (unchanged and skipped,
+    // or headless).
+    bool draw(const CameraMatrices &camera, const std::vector<std::shared_ptr<UIContainer>> &uiElements, const std::vector<std::shared_ptr<WorldContainer>> &worldElements);
+    void drawUI(const std::vector<std::shared_ptr<UIContainer>> &uiElements, DrawList *drawList);
+    // draw() split so recording can leave the main thread. recordWorld()
+    // (renderables and world elements) and recordUI() may run on a worker,
+    // concurrently with each other, only while the draw and render paths
+    // they reach read shared state and write their own meshes. FontManager
+    // and GlyphAtlas are main-thread only, so fonts, text primitives and
+    // LOD levels must exist before recording starts. submit() then joins
+    // the two lists in draw() order and submits them from the thread that
+    // owns the renderer.
+    void recordWorld(const CameraMatrices &camera, const std::vector<std::shared_ptr<WorldContainer>> &worldElements);
+    void recordUI(const std::vector<std::shared_ptr<UIContainer>> &uiElements);
+    bool submit();
+    // Blocks until every queued frame has been submitted.
+    void flush();
+
+    // Seconds the last draw() spent blocked on the drawable or on a full
+    // render queue rather than working.
+    double lastBlockedSeconds() const { return blockedSeconds; }
+    // Receives each frame's display present time (seconds) on a Metal thread.
+    void setPresentHandler(std::function<void(double)> handler) { presentHandler = std::move(handler); }
 
     MTL::CommandBuffer* createUICommandBuffer();
     MTL::RenderCommandEncoder* createUIEncoder(MTL::CommandBuffer* commandBuffer, CA::MetalDrawable** outDrawable);
@@ -24,8 +59,38 @@ public:
 
     void setOrthoParams(float left, float right, float bottom, float top, float near, float far);
     void setClearColor(const MTL::ClearColor &color) { clearColor = color; }
+    // When set, a frame whose draw list matches the last submitted one is
+    // dropped unless Redraw has a request pending.
+    void setSkipUnchangedFrames(bool skip) { skipUnchanged = skip; }
+    // Renders World depth-mode draws at a scale that follows GPU frame time
+    // against budgetSeconds and upscales them to the drawable; Overlay draws
+    // (UI, screen-space renderables) stay at native resolution and on top.
+    // Enabling builds the upscale pipeline on the calling thread and falls
+    // back to native resolution if that fails. May be called at any time;
+    // the change is handed over under frameMutex and takes effect from the
+    // next frame encoded.
+    void setDynamicResolution(bool enabled, double budgetSeconds, float minScale = 0.5f);
+    float resolutionScale() const { return currentScale.load(std::memory_order_relaxed); }
+    size_t renderableCount() const { return renderables.size(); }
 
 private:
+    struct Frame {
+        DrawList drawList;
+        MTL::ClearColor clearColor;
+    };
+
+    // Returns seconds spent waiting for the drawable.
+    double encode(Frame &frame);
+    // Renders the World draws into sceneTexture at the given scale; false if
+    // the target or upscale pipeline isn't available.
+    bool encodeScaledScene(MTL::CommandBuffer *commandBuffer, Frame &frame, float scale,
+                           uint32_t width, uint32_t height);
+    void encodeUpscale(MTL::RenderCommandEncoder *encoder, float scale, uint32_t width, uint32_t height);
+    void renderLoop();
+    void recycle(std::unique_ptr<Frame> frame);
+    // Takes the latest setDynamicResolution() settings on the encoding thread.
+    void applyPendingResolution();
+
     MTL::Device *device;
     CA::MetalLayer *metalLayer;
     CA::MetalDrawable *drawableArea;
@@ -35,6 +100,42 @@ private:
     MTL::Texture *depthTexture;
 
     std::vector<std::shared_ptr<Renderable>> renderables;
+    DrawList worldDraws;
+    DrawList uiDraws;
     MTL::ClearColor clearColor;
     float orthoLeft, orthoRight, orthoBottom, orthoTop, orthoNear, orthoFar;
+
+    bool skipUnchanged = false;
+    double blockedSeconds = 0.0;
+    std::function<void(double)> presentHandler;
+    uint64_t lastSignature = 0;
+    MTL::ClearColor lastClearColor;
+
+    struct ResolutionSettings {
+        bool enabled = false;
+        double budgetSeconds = 1.0 / 60.0;
+        float minScale = 0.5f;
+    };
+    // Guarded by frameMutex.
+    ResolutionSettings pendingResolution;
+    bool resolutionPending = false;
+    // Encoding thread only.
+    bool dynamicResolution = false;
+    ResolutionScaler resolutionScaler;
+    std::atomic<float> currentScale{1.0f};
+    // Written by command buffer completion handlers, which may outlive us.
+    std::shared_ptr<std::atomic<double>> gpuFrameSeconds;
+    std::unique_ptr<Shader> upscaleShader;
+    MTL::SamplerState *upscaleSampler = nullptr;
+    MTL::Texture *sceneTexture = nullptr;
+
+    unsigned latencyFrames;
+    std::vector<std::unique_ptr<Frame>> freeFrames;
+    std::deque<std::unique_ptr<Frame>> queuedFrames;
+    std::mutex frameMutex;
+    std::condition_variable frameQueued;
+    std::condition_variable frameTaken;
+    bool encoding = false;
+    bool stopping = false;
+    std::thread renderThread;
 };
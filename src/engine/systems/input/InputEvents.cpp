@@ -0,0 +1,135 @@
+#include "engine/systems/input/InputEvents.h"
+#include "engine/core/Metrics.h"
+#include "engine/core/Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t QUEUE_CAPACITY = 1024;
+    constexpr uint32_t QUEUE_MASK = QUEUE_CAPACITY - 1;
+
+    InputEvent g_ring[QUEUE_CAPACITY];
+    std::atomic<uint32_t> g_head{0};
+    std::atomic<uint32_t> g_tail{0};
+
+    struct ListenerEntry
+    {
+        InputEvents::ListenerId id;
+        InputEvents::Listener listener;
+        bool removed = false;
+    };
+
+    std::vector<ListenerEntry> g_listeners;
+    std::vector<ListenerEntry> g_addedListeners;
+    std::vector<InputEvent> g_batch;
+    InputEvents::ListenerId g_nextListenerId = 1;
+    bool g_dispatching = false;
+}
+
+bool InputEvents::push(const InputEvent &event)
+{
+    uint32_t head = g_head.load(std::memory_order_relaxed);
+    if (head - g_tail.load(std::memory_order_acquire) >= QUEUE_CAPACITY) {
+        METRIC_COUNT("input.dropped", 1);
+        return false;
+    }
+    g_ring[head & QUEUE_MASK] = event;
+    g_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void InputEvents::pushCursor(double x, double y)
+{
+    InputEvent event;
+    event.type = InputEvent::Type::CursorMove;
+    event.timeNs = Profiler::nowNs();
+    event.x = x;
+    event.y = y;
+    push(event);
+}
+
+void InputEvents::pushMouseButton(int button, bool pressed, double x, double y)
+{
+    InputEvent event;
+    event.type = InputEvent::Type::MouseButton;
+    event.timeNs = Profiler::nowNs();
+    event.x = x;
+    event.y = y;
+    event.code = button;
+    event.pressed = pressed;
+    push(event);
+}
+
+void InputEvents::pushKey(int key, bool pressed)
+{
+    InputEvent event;
+    event.type = InputEvent::Type::Key;
+    event.timeNs = Profiler::nowNs();
+    event.code = key;
+    event.pressed = pressed;
+    push(event);
+}
+
+InputEvents::ListenerId InputEvents::addListener(Listener listener)
+{
+    ListenerEntry entry{g_nextListenerId++, std::move(listener)};
+    ListenerId id = entry.id;
+    if (g_dispatching) {
+        g_addedListeners.push_back(std::move(entry));
+    } else {
+        g_listeners.push_back(std::move(entry));
+    }
+    return id;
+}
+
+void InputEvents::removeListener(ListenerId id)
+{
+    auto matches = [id](const ListenerEntry &entry) { return entry.id == id; };
+    g_addedListeners.erase(std::remove_if(g_addedListeners.begin(), g_addedListeners.end(), matches),
+                           g_addedListeners.end());
+    if (g_dispatching) {
+        for (ListenerEntry &entry : g_listeners) {
+            if (entry.id == id) entry.removed = true;
+        }
+    } else {
+        g_listeners.erase(std::remove_if(g_listeners.begin(), g_listeners.end(), matches), g_listeners.end());
+    }
+}
+
+size_t InputEvents::dispatch()
+{
+    uint32_t tail = g_tail.load(std::memory_order_relaxed);
+    uint32_t head = g_head.load(std::memory_order_acquire);
+    if (head == tail) {
+        return 0;
+    }
+
+    g_batch.clear();
+    for (uint32_t i = tail; i != head; ++i) {
+        g_batch.push_back(g_ring[i & QUEUE_MASK]);
+    }
+    g_tail.store(head, std::memory_order_release);
+    METRIC_COUNT("input.events", g_batch.size());
+
+    g_dispatching = true;
+    for (const InputEvent &event : g_batch) {
+        for (size_t i = 0; i < g_listeners.size(); ++i) {
+            if (!g_listeners[i].removed) {
+                g_listeners[i].listener(event);
+            }
+        }
+    }
+    g_dispatching = false;
+
+    g_listeners.erase(std::remove_if(g_listeners.begin(), g_listeners.end(),
+                                     [](const ListenerEntry &entry) { return entry.removed; }),
+                      g_listeners.end());
+    for (ListenerEntry &entry : g_addedListeners) {
+        g_listeners.push_back(std::move(entry));
+    }
+    g_addedListeners.clear();
+    return g_batch.size();
+}
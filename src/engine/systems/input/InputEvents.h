@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+struct InputEvent {
+    enum class Type : uint8_t {
+        CursorMove,
+        MouseButton,
+        Key
+    };
+
+    Type type = Type::CursorMove;
+    // Profiler::nowNs() clock, taken when the event was queued.
+    int64_t timeNs = 0;
+    // Cursor position in window coordinates (top-left origin); for button
+    // events, where the cursor was when the button changed.
+    double x = 0.0;
+    double y = 0.0;
+    // GLFW mouse button or key.
+    int code = 0;
+    bool pressed = false;
+};
+
+/**
+ * Input events queued as they arrive (from GLFW callbacks or scripts) and
+ * delivered once per frame, in order, to listeners. Unlike polling
+ * InputState, a press and release inside one frame are both seen.
+ * The queue is a lock-free ring for one producer thread and one consumer
+ * thread; full queues drop events (counted in input.dropped).
+ */
+class InputEvents {
+public:
+    using ListenerId = uint64_t;
+    using Listener = std::function<void(const InputEvent&)>;
+
+    static bool push(const InputEvent &event);
+    static void pushCursor(double x, double y);
+    static void pushMouseButton(int button, bool pressed, double x, double y);
+    static void pushKey(int key, bool pressed);
+
+    // Listeners added or removed during dispatch take effect afterwards.
+    static ListenerId addListener(Listener listener);
+    static void removeListener(ListenerId id);
+
+    // Delivers everything queued so far; returns the number of events.
+    static size_t dispatch();
+};
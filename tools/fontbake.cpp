@@ -0,0 +1,134 @@
+// Bakes every face under a font directory serially and with the job
+// system, checks that the two atlases are byte-identical and reports the
+// timings.
+//
+//   fontbake [--workers N] [--repeat N] [data/fonts]
+
+#include "engine/core/FontBake.h"
+#include "engine/core/JobSystem.h"
+#include "engine/core/LogManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int FIRST_CHAR = 32;
+    constexpr int NUM_CHARS = 96;
+    constexpr int INITIAL_SIZE = 512;
+    constexpr int MAX_SIZE = 1024;
+    constexpr float SIZES[] = {16.0f, 32.0f, 64.0f};
+
+    bool readFile(const std::filesystem::path &path, std::vector<unsigned char> &bytes)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+            return false;
+        bytes.resize((size_t)file.tellg());
+        file.seekg(0, std::ios::beg);
+        return (bool)file.read((char *)bytes.data(), (std::streamsize)bytes.size());
+    }
+
+    // Best of `repeat` runs, in milliseconds.
+    double timeBake(const stbtt_fontinfo *info, float size, JobSystem *jobs, int repeat, FontBake::Result &result)
+    {
+        double best = 0.0;
+        for (int i = 0; i < repeat; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            if (!FontBake::rasterize(info, size, FIRST_CHAR, NUM_CHARS, INITIAL_SIZE, MAX_SIZE, jobs, result))
+                return -1.0;
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = i == 0 ? ms : std::min(best, ms);
+        }
+        return best;
+    }
+
+    bool identical(const FontBake::Result &a, const FontBake::Result &b)
+    {
+        return a.size == b.size &&
+               a.pixels == b.pixels &&
+               a.packedChars.size() == b.packedChars.size() &&
+               std::memcmp(a.packedChars.data(), b.packedChars.data(),
+                           a.packedChars.size() * sizeof(stbtt_packedchar)) == 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string root = "data/fonts";
+    unsigned workers = 0;
+    int repeat = 5;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+            workers = (unsigned)std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = std::max(1, std::atoi(argv[++i]));
+        else
+            root = argv[i];
+    }
+
+    std::vector<std::filesystem::path> faces;
+    std::error_code error;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(root, error))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".ttf")
+            faces.push_back(entry.path());
+    }
+    std::sort(faces.begin(), faces.end());
+    if (faces.empty())
+    {
+        std::fprintf(stderr, "fontbake: no .ttf faces under %s\n", root.c_str());
+        return 1;
+    }
+
+    JobSystem jobs(workers);
+    std::printf("%zu faces, %u workers + caller, best of %d\n\n", faces.size(), jobs.workerCount(), repeat);
+    std::printf("%-40s %6s %10s %10s %8s\n", "face", "size", "serial ms", "jobs ms", "speedup");
+
+    int mismatches = 0;
+    double serialTotal = 0.0;
+    double parallelTotal = 0.0;
+    for (const auto &path : faces)
+    {
+        std::vector<unsigned char> bytes;
+        stbtt_fontinfo info;
+        if (!readFile(path, bytes) || !stbtt_InitFont(&info, bytes.data(), 0))
+        {
+            std::printf("%-40s failed to load\n", path.filename().string().c_str());
+            ++mismatches;
+            continue;
+        }
+
+        for (float size : SIZES)
+        {
+            FontBake::Result serial;
+            FontBake::Result parallel;
+            double serialMs = timeBake(&info, size, nullptr, repeat, serial);
+            double parallelMs = timeBake(&info, size, &jobs, repeat, parallel);
+            bool same = serialMs >= 0.0 && parallelMs >= 0.0 && identical(serial, parallel);
+            if (!same)
+                ++mismatches;
+            serialTotal += serialMs;
+            parallelTotal += parallelMs;
+            std::printf("%-40s %6.0f %10.3f %10.3f %7.2fx%s\n", path.filename().string().c_str(), size,
+                        serialMs, parallelMs, parallelMs > 0.0 ? serialMs / parallelMs : 0.0,
+                        same ? "" : "  MISMATCH");
+        }
+    }
+
+    std::printf("\ntotal %47.3f %10.3f %7.2fx\n", serialTotal, parallelTotal,
+                parallelTotal > 0.0 ? serialTotal / parallelTotal : 0.0);
+    if (mismatches)
+        std::printf("%d bakes differ between serial and parallel\n", mismatches);
+    LogManager::shutdown();
+    return mismatches ? 1 : 0;
+}
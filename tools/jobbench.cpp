@@ -0,0 +1,158 @@
+// Job system scaling from 1 to N threads (workers plus the calling thread).
+//
+//   jobbench [--max-threads N] [--repeat N]
+//
+// Workloads:
+//   mesh       parallelFor over sphere vertex generation, even cost per item
+//   uneven     parallelFor where item cost grows with the index, so chunks
+//              finish at different times and idle workers have to steal
+//   tiny       many near-empty submit() jobs, measuring scheduling overhead
+// One thread runs the work inline with no pool as the baseline.
+
+#include "engine/core/JobSystem.h"
+#include "engine/core/LogManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr size_t MESH_VERTICES = 1 << 21;
+    constexpr size_t UNEVEN_ITEMS = 1 << 14;
+    constexpr size_t TINY_JOBS = 1 << 16;
+
+    struct Vertex
+    {
+        float x, y, z;
+        float u, v;
+    };
+
+    std::vector<Vertex> g_vertices(MESH_VERTICES);
+    std::vector<double> g_uneven(UNEVEN_ITEMS);
+
+    void buildSphere(size_t begin, size_t end)
+    {
+        const size_t rings = 1024;
+        const size_t segments = MESH_VERTICES / rings;
+        for (size_t i = begin; i < end; ++i) {
+            float u = (float)(i % segments) / (float)segments;
+            float v = (float)(i / segments) / (float)rings;
+            float theta = u * 6.2831853f;
+            float phi = v * 3.1415926f;
+            g_vertices[i] = {std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta), u, v};
+        }
+    }
+
+    void unevenWork(size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i) {
+            double acc = 0.0;
+            size_t steps = 16 + i / 16;
+            for (size_t k = 0; k < steps; ++k) {
+                acc += std::sqrt((double)(i * k + 1));
+            }
+            g_uneven[i] = acc;
+        }
+    }
+
+    // Runs with `threads` total threads; 1 runs inline without a pool.
+    using Workload = std::function<void(JobSystem *jobs)>;
+
+    double timeWorkload(const Workload &workload, unsigned threads, int repeat)
+    {
+        std::unique_ptr<JobSystem> jobs;
+        if (threads > 1) {
+            jobs = std::make_unique<JobSystem>(threads - 1);
+        }
+        double best = 0.0;
+        for (int i = 0; i < repeat; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            workload(jobs.get());
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = i == 0 ? ms : std::min(best, ms);
+        }
+        return best;
+    }
+
+    void parallel(JobSystem *jobs, size_t count, size_t grain, void (*body)(size_t, size_t))
+    {
+        if (jobs) {
+            jobs->parallelFor(0, count, grain, body);
+        } else {
+            body(0, count);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    int repeat = 5;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+            maxThreads = (unsigned)std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::fprintf(stderr, "usage: jobbench [--max-threads N] [--repeat N]\n");
+            return 1;
+        }
+    }
+    LogManager::setEnabled(LogManager::Level::Info, false);
+
+    struct Entry
+    {
+        const char *name;
+        Workload run;
+    };
+    const Entry workloads[] = {
+        {"mesh", [](JobSystem *jobs) { parallel(jobs, MESH_VERTICES, 16384, buildSphere); }},
+        {"uneven", [](JobSystem *jobs) { parallel(jobs, UNEVEN_ITEMS, 64, unevenWork); }},
+        {"tiny", [](JobSystem *jobs) {
+             std::vector<JobSystem::Handle> handles;
+             handles.reserve(TINY_JOBS);
+             for (size_t i = 0; i < TINY_JOBS; ++i) {
+                 if (jobs) {
+                     handles.push_back(jobs->submit([i] { g_uneven[i % UNEVEN_ITEMS] += 1.0; }));
+                 } else {
+                     g_uneven[i % UNEVEN_ITEMS] += 1.0;
+                 }
+             }
+             for (const auto &handle : handles) {
+                 jobs->wait(handle);
+             }
+         }},
+    };
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(maxThreads);
+
+    std::printf("%u hardware threads, best of %d\n\n", std::thread::hardware_concurrency(), repeat);
+    std::printf("%-8s %8s %12s %9s %11s\n", "workload", "threads", "ms", "speedup", "efficiency");
+    for (const Entry &workload : workloads) {
+        double baseline = 0.0;
+        for (unsigned threads : threadCounts) {
+            double ms = timeWorkload(workload.run, threads, repeat);
+            if (threads == 1) {
+                baseline = ms;
+            }
+            double speedup = ms > 0.0 ? baseline / ms : 0.0;
+            std::printf("%-8s %8u %12.3f %8.2fx %10.0f%%\n", workload.name, threads, ms, speedup,
+                        speedup / threads * 100.0);
+        }
+    }
+
+    LogManager::shutdown();
+    return 0;
+}
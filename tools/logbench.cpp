@@ -0,0 +1,146 @@
+// Log throughput under multi-threaded load.
+//
+//   logbench [--threads 1,2,4,8] [--count N]
+//
+// For each thread count, every thread issues N LOG_INFO calls with three
+// arguments into a sink that only counts lines; reported are producer
+// throughput, time until flush() returns, and drops. A second table times
+// timestamping alone: the system_clock + strftime-per-line path logs used
+// before monotonic stamps and cached prefixes, against the current one.
+
+#include "engine/core/LogClock.h"
+#include "engine/core/LogManager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    class CountingSink : public LogManager::LogSink
+    {
+    public:
+        void write(const LogManager::LogLine &) override { lines.fetch_add(1, std::memory_order_relaxed); }
+
+        std::atomic<uint64_t> lines{0};
+    };
+
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Runs body(thread) on `threads` threads released together; returns
+    // the wall time until the last one finishes.
+    template <typename Body>
+    double runThreads(unsigned threads, Body body)
+    {
+        std::atomic<bool> go{false};
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; ++t) {
+            pool.emplace_back([&, t] {
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                body(t);
+            });
+        }
+        auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto &thread : pool) {
+            thread.join();
+        }
+        return secondsSince(start);
+    }
+
+    void legacyStamp(char *out)
+    {
+        auto now = std::chrono::system_clock::now();
+        std::time_t t = std::chrono::system_clock::to_time_t(now);
+        int millis = (int)(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000);
+        std::tm tm{};
+        localtime_r(&t, &tm);
+        size_t length = std::strftime(out, 32, "%Y-%m-%d %H:%M:%S", &tm);
+        std::snprintf(out + length, 32 - length, ".%03d", millis);
+    }
+
+    void currentStamp(LogManager::TimestampFormatter &formatter, char *out)
+    {
+        formatter.format(LogManager::wallFromMonotonic(LogManager::monotonicNs()), out);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<unsigned> threadCounts{1, 2, 4, 8};
+    unsigned count = 200000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCounts.clear();
+            for (char *item = std::strtok(argv[++i], ","); item; item = std::strtok(nullptr, ",")) {
+                threadCounts.push_back((unsigned)std::max(1, std::atoi(item)));
+            }
+        } else if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            count = (unsigned)std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::fprintf(stderr, "usage: logbench [--threads 1,2,4,8] [--count N]\n");
+            return 1;
+        }
+    }
+
+    auto sink = std::make_shared<CountingSink>();
+    LogManager::clearSinks();
+    LogManager::addSink(sink);
+
+    std::printf("%u hardware threads, %u calls per thread\n\n", std::thread::hardware_concurrency(), count);
+    std::printf("%8s %14s %14s %12s %10s\n", "threads", "calls/s", "drained/s", "flush ms", "dropped");
+    for (unsigned threads : threadCounts) {
+        sink->lines.store(0);
+        uint64_t droppedBefore = LogManager::droppedCount();
+
+        auto start = std::chrono::steady_clock::now();
+        double produce = runThreads(threads, [count](unsigned thread) {
+            for (unsigned i = 0; i < count; ++i) {
+                LOG_INFO("bench thread=%u i=%u value=%f", thread, i, i * 0.5);
+            }
+        });
+        auto flushStart = std::chrono::steady_clock::now();
+        LogManager::flush();
+        double flushSeconds = secondsSince(flushStart);
+        double total = secondsSince(start);
+
+        uint64_t calls = (uint64_t)threads * count;
+        uint64_t dropped = LogManager::droppedCount() - droppedBefore;
+        std::printf("%8u %14.0f %14.0f %12.2f %10llu\n", threads, calls / produce,
+                    (double)(calls - dropped) / total, flushSeconds * 1000.0, (unsigned long long)dropped);
+    }
+
+    std::printf("\ntimestamps (ns per line)\n%8s %14s %14s\n", "threads", "legacy", "current");
+    for (unsigned threads : threadCounts) {
+        double legacy = runThreads(threads, [count](unsigned) {
+            char out[32];
+            for (unsigned i = 0; i < count; ++i) {
+                legacyStamp(out);
+            }
+        });
+        double current = runThreads(threads, [count](unsigned) {
+            LogManager::TimestampFormatter formatter;
+            char out[LogManager::TimestampFormatter::LENGTH + 1];
+            for (unsigned i = 0; i < count; ++i) {
+                currentStamp(formatter, out);
+            }
+        });
+        std::printf("%8u %14.1f %14.1f\n", threads, legacy * 1e9 / count, current * 1e9 / count);
+    }
+
+    LogManager::shutdown();
+    return 0;
+}
@@ -0,0 +1,238 @@
+// Decodes a binary log capture written by LogManager::openBinaryCapture into
+// the same text format the console backend prints.
+//
+//   logdecode [--color] capture.bin
+
+#include "engine/core/LogCapture.h"
+#include "engine/core/LogClock.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    struct DecodedSite
+    {
+        uint32_t line;
+        LogManager::Level level;
+        std::string file;
+        std::string tag;
+        bool hasTag;
+        std::string fmt;
+    };
+
+    bool g_color = false;
+
+    const char *color(const char *code)
+    {
+        return g_color ? code : "";
+    }
+
+    const char *levelColor(LogManager::Level level)
+    {
+        switch (level)
+        {
+        case LogManager::Level::Info:
+            return color("\033[0;32m");
+        case LogManager::Level::Debug:
+            return color("\033[1;33m");
+        case LogManager::Level::Error:
+            return color("\033[0;31m");
+        }
+        return color("\033[0m");
+    }
+
+    // Every string argument must end inside the event's string bytes, on
+    // the terminator its length promises.
+    bool stringArgsValid(const LogManager::LogArg *args, size_t argCount, const char *strings, size_t stringBytes)
+    {
+        for (size_t i = 0; i < argCount; ++i) {
+            if (args[i].type != LogManager::ArgType::String) {
+                continue;
+            }
+            size_t terminator = (size_t)args[i].s.offset + args[i].s.length;
+            if (terminator >= stringBytes || strings[terminator] != '\0') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void reportCorrupt(uint64_t site, const char *reason)
+    {
+        std::printf("%s[CORRUPT]%s event for site %016llx skipped: %s\n", color("\033[0;31m"), color("\033[0m"),
+                    (unsigned long long)site, reason);
+    }
+
+    const char *levelName(LogManager::Level level)
+    {
+        switch (level)
+        {
+        case LogManager::Level::Info:
+            return "INFO";
+        case LogManager::Level::Debug:
+            return "DEBUG";
+        case LogManager::Level::Error:
+            return "ERROR";
+        }
+        return "?";
+    }
+
+    bool readFile(const char *path, std::vector<unsigned char> &data)
+    {
+        FILE *file = std::fopen(path, "rb");
+        if (!file) {
+            return false;
+        }
+        unsigned char chunk[65536];
+        size_t count;
+        while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            data.insert(data.end(), chunk, chunk + count);
+        }
+        std::fclose(file);
+        return true;
+    }
+
+    // Calls visit(kind, body, bodyBytes) for every complete record.
+    template <typename Visit>
+    void forEachRecord(const std::vector<unsigned char> &data, size_t end, Visit visit)
+    {
+        size_t offset = sizeof(LogManager::CaptureFileHeader);
+        while (offset + sizeof(LogManager::CaptureRecordHeader) <= end) {
+            LogManager::CaptureRecordHeader header;
+            std::memcpy(&header, data.data() + offset, sizeof(header));
+            if (header.size < sizeof(header) || offset + header.size > end) {
+                break;
+            }
+            visit((LogManager::CaptureRecordKind)header.kind, data.data() + offset + sizeof(header),
+                  header.size - sizeof(header));
+            offset += header.size;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--color") == 0) {
+            g_color = true;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path) {
+        std::fprintf(stderr, "usage: %s [--color] capture.bin\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<unsigned char> data;
+    if (!readFile(path, data) || data.size() < sizeof(LogManager::CaptureFileHeader)) {
+        std::fprintf(stderr, "logdecode: cannot read %s\n", path);
+        return 1;
+    }
+
+    LogManager::CaptureFileHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, LogManager::CAPTURE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != LogManager::CAPTURE_VERSION) {
+        std::fprintf(stderr, "logdecode: %s is not a version %u log capture\n", path, LogManager::CAPTURE_VERSION);
+        return 1;
+    }
+
+    // usedBytes is only written on close; a capture from a process that
+    // crashed is read up to the first unfinished record instead.
+    size_t end = header.usedBytes ? (size_t)header.usedBytes : data.size();
+    if (end > data.size()) {
+        end = data.size();
+    }
+
+    std::unordered_map<uint64_t, DecodedSite> sites;
+    forEachRecord(data, end, [&](LogManager::CaptureRecordKind kind, const unsigned char *body, size_t bytes) {
+        if (kind != LogManager::CaptureRecordKind::Site || bytes < sizeof(LogManager::CaptureSite)) {
+            return;
+        }
+        LogManager::CaptureSite site;
+        std::memcpy(&site, body, sizeof(site));
+        if (sizeof(site) + site.fileLength + site.tagLength + site.fmtLength + 3 > bytes) {
+            return;
+        }
+        const char *strings = (const char *)body + sizeof(site);
+        DecodedSite &decoded = sites[site.id];
+        decoded.line = site.line;
+        decoded.level = (LogManager::Level)site.level;
+        decoded.file.assign(strings, site.fileLength);
+        decoded.tag.assign(strings + site.fileLength + 1, site.tagLength);
+        decoded.hasTag = site.hasTag != 0;
+        decoded.fmt.assign(strings + site.fileLength + site.tagLength + 2, site.fmtLength);
+    });
+
+    LogManager::ClockBase clock{header.startMonotonicNs, header.startTimestampNs};
+    LogManager::TimestampFormatter formatter;
+    size_t events = 0;
+    size_t unknown = 0;
+    size_t corrupt = 0;
+    forEachRecord(data, end, [&](LogManager::CaptureRecordKind kind, const unsigned char *body, size_t bytes) {
+        if (kind != LogManager::CaptureRecordKind::Event || bytes < sizeof(LogManager::CaptureEvent)) {
+            return;
+        }
+        LogManager::CaptureEvent event;
+        std::memcpy(&event, body, sizeof(event));
+        size_t argBytes = event.argCount * sizeof(LogManager::LogArg);
+        if (event.argCount > LogManager::LogRecord::MAX_ARGS ||
+            event.stringBytes > LogManager::LogRecord::STRING_BYTES ||
+            sizeof(event) + argBytes + event.stringBytes > bytes) {
+            reportCorrupt(event.id, "size fields exceed the record");
+            ++corrupt;
+            return;
+        }
+
+        auto it = sites.find(event.id);
+        if (it == sites.end()) {
+            ++unknown;
+            return;
+        }
+        const DecodedSite &site = it->second;
+
+        LogManager::LogArg args[LogManager::LogRecord::MAX_ARGS];
+        std::memcpy(args, body + sizeof(event), argBytes);
+        char strings[LogManager::LogRecord::STRING_BYTES];
+        std::memcpy(strings, body + sizeof(event) + argBytes, event.stringBytes);
+        if (!stringArgsValid(args, event.argCount, strings, event.stringBytes)) {
+            reportCorrupt(event.id, "string argument out of bounds");
+            ++corrupt;
+            return;
+        }
+
+        char message[1024];
+        LogManager::formatMessage(site.fmt.c_str(), args, event.argCount, strings, event.stringBytes,
+                                  message, sizeof(message));
+
+        char timestr[LogManager::TimestampFormatter::LENGTH + 1];
+        formatter.format(LogManager::wallFromMonotonic(event.monotonicNs, clock), timestr);
+
+        if (site.hasTag) {
+            std::printf("%s[%s] %s%s [%s] - %s\n", levelColor(site.level), levelName(site.level),
+                        color("\033[0m"), timestr, site.tag.c_str(), message);
+        } else {
+            std::printf("%s[%s] %s%s - %s\n", levelColor(site.level), levelName(site.level),
+                        color("\033[0m"), timestr, message);
+        }
+        ++events;
+    });
+
+    if (corrupt > 0) {
+        std::fprintf(stderr, "logdecode: skipped %zu corrupt events\n", corrupt);
+    }
+    if (unknown > 0) {
+        std::fprintf(stderr, "logdecode: %zu events reference unknown sites\n", unknown);
+    }
+    if (header.droppedRecords > 0) {
+        std::fprintf(stderr, "logdecode: capture overflowed, %llu records were dropped\n",
+                     (unsigned long long)header.droppedRecords);
+    }
+    return 0;
+}
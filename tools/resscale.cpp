@@ -0,0 +1,176 @@
+// Drives ResolutionScaler with synthetic GPU frame times and checks that it
+// settles instead of oscillating.
+//
+//   resscale [--seed N] [--verbose]
+//
+// Each scenario is a sequence of load phases. A frame at scale s costs
+// budget * load * (FIXED_SHARE + (1 - FIXED_SHARE) * s^2) with multiplicative
+// noise, optional spikes, and the scaler sees it GPU_LAG_FRAMES later as it
+// would from command buffer completion. A scenario fails when, within one
+// phase, the scale flips back to where it was (A -> B -> A) inside
+// REVERSAL_WINDOW frames, when a phase changes scale more than
+// MAX_CHANGES_PER_PHASE times, or when a phase ends over budget while the
+// scaler could still drop.
+
+#include "engine/core/LogManager.h"
+#include "engine/core/ResolutionScaler.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr double BUDGET = 1.0 / 60.0;
+    constexpr float MIN_SCALE = 0.5f;
+    constexpr double FIXED_SHARE = 0.15;
+    constexpr int GPU_LAG_FRAMES = 2;
+    constexpr int REVERSAL_WINDOW = 120;
+    constexpr int MAX_CHANGES_PER_PHASE = 4;
+
+    struct Phase
+    {
+        int frames;
+        // Frame cost at full scale over the budget.
+        double load;
+        // Relative standard deviation of per-frame noise.
+        double noise;
+        // Chance per frame of a 3x spike.
+        double spikeChance;
+    };
+
+    struct Scenario
+    {
+        const char *name;
+        std::vector<Phase> phases;
+    };
+
+    struct Outcome
+    {
+        int changes = 0;
+        int flips = 0;
+        int worstPhaseChanges = 0;
+        bool overBudget = false;
+        float finalScale = 1.0f;
+        double finalRatio = 0.0;
+    };
+
+    Outcome run(const Scenario &scenario, unsigned seed, bool verbose)
+    {
+        std::mt19937 rng(seed);
+        std::normal_distribution<double> gauss(0.0, 1.0);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+        ResolutionScaler scaler(BUDGET);
+        scaler.setRange(MIN_SCALE, 1.0f);
+        // GPU time and phase of each frame not yet reported.
+        std::deque<std::pair<double, size_t>> inFlight;
+        Outcome outcome;
+
+        // Changes are charged to the phase of the sample that triggered
+        // them, so a reaction to the previous load isn't taken for a flip.
+        size_t changePhase = 0;
+        int phaseChanges = 0;
+        int lastChangeFrame = 0;
+        float scaleBeforeChange = -1.0f;
+
+        int frame = 0;
+        for (size_t p = 0; p < scenario.phases.size(); ++p) {
+            const Phase &phase = scenario.phases[p];
+            for (int i = 0; i < phase.frames; ++i, ++frame) {
+                const float scale = scaler.scale();
+                double cost = BUDGET * phase.load * (FIXED_SHARE + (1.0 - FIXED_SHARE) * scale * scale);
+                cost *= std::max(0.1, 1.0 + phase.noise * gauss(rng));
+                if (uniform(rng) < phase.spikeChance) {
+                    cost *= 3.0;
+                }
+                inFlight.emplace_back(cost, p);
+                if ((int)inFlight.size() <= GPU_LAG_FRAMES) {
+                    scaler.update(0.0);
+                    continue;
+                }
+                const auto [measured, measuredPhase] = inFlight.front();
+                inFlight.pop_front();
+
+                const float next = scaler.update(measured);
+                if (next == scale) {
+                    continue;
+                }
+
+                if (measuredPhase != changePhase) {
+                    changePhase = measuredPhase;
+                    phaseChanges = 0;
+                    scaleBeforeChange = -1.0f;
+                }
+                if (verbose) {
+                    std::printf("  %-12s frame %5d  %.2f -> %.2f  smoothed %.2f of budget\n", scenario.name, frame,
+                                scale, next, scaler.smoothedSeconds() / BUDGET);
+                }
+                if (next == scaleBeforeChange && frame - lastChangeFrame <= REVERSAL_WINDOW) {
+                    ++outcome.flips;
+                }
+                scaleBeforeChange = scale;
+                lastChangeFrame = frame;
+                outcome.worstPhaseChanges = std::max(outcome.worstPhaseChanges, ++phaseChanges);
+                ++outcome.changes;
+            }
+
+            const double ratio = scaler.smoothedSeconds() / BUDGET;
+            if (ratio > 1.0 && scaler.scale() > scaler.minScale() && phase.spikeChance == 0.0) {
+                outcome.overBudget = true;
+            }
+        }
+
+        outcome.finalScale = scaler.scale();
+        outcome.finalRatio = scaler.smoothedSeconds() / BUDGET;
+        return outcome;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned seed = 1;
+    bool verbose = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned)std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else {
+            std::fprintf(stderr, "usage: resscale [--seed N] [--verbose]\n");
+            return 1;
+        }
+    }
+
+    const Scenario scenarios[] = {
+        {"light", {{1800, 0.5, 0.05, 0.0}}},
+        {"heavy", {{1800, 1.4, 0.05, 0.0}}},
+        {"overloaded", {{1800, 3.0, 0.05, 0.0}}},
+        {"threshold", {{3600, 0.95, 0.08, 0.0}}},
+        {"noisy", {{3600, 1.2, 0.15, 0.0}}},
+        {"spikes", {{3600, 0.7, 0.05, 0.02}}},
+        {"load steps", {{900, 0.6, 0.05, 0.0}, {900, 1.5, 0.05, 0.0}, {900, 0.6, 0.05, 0.0}, {900, 1.1, 0.05, 0.0}}},
+        {"sawtooth", {{300, 0.8, 0.05, 0.0}, {300, 1.3, 0.05, 0.0}, {300, 0.8, 0.05, 0.0}, {300, 1.3, 0.05, 0.0},
+                      {300, 0.8, 0.05, 0.0}, {300, 1.3, 0.05, 0.0}}},
+    };
+
+    std::printf("%-12s %8s %10s %10s %7s %7s  %s\n", "scenario", "changes", "flips", "max/phase", "scale",
+                "ratio", "result");
+    int failed = 0;
+    for (const Scenario &scenario : scenarios) {
+        const Outcome outcome = run(scenario, seed, verbose);
+        const bool ok = outcome.flips == 0 && outcome.worstPhaseChanges <= MAX_CHANGES_PER_PHASE &&
+                        !outcome.overBudget;
+        failed += ok ? 0 : 1;
+        std::printf("%-12s %8d %10d %10d %7.2f %7.2f  %s%s\n", scenario.name, outcome.changes, outcome.flips,
+                    outcome.worstPhaseChanges, outcome.finalScale, outcome.finalRatio, ok ? "ok" : "FAIL",
+                    outcome.overBudget ? " (over budget)" : "");
+    }
+
+    LogManager::shutdown();
+    return failed == 0 ? 0 : 1;
+}